@@ -0,0 +1,18 @@
+# Header-only serialization library (src/serialize_core.hpp and the front-ends around it).
+# Other tasks of the course use it with include(<path to task-1-serialize>/serialize_core.cmake)
+# and target_link_libraries(<target> serialize_core).
+#
+# serialize_instrumentation (src/serialize_instrumentation.hpp) is opt-in: it replaces the global
+# operator new of the program, so only the targets that count allocations link it.
+
+if(NOT TARGET serialize_core)
+    find_package(Threads REQUIRED)
+
+    add_library(serialize_core INTERFACE)
+    target_include_directories(serialize_core INTERFACE ${CMAKE_CURRENT_LIST_DIR}/src)
+    target_compile_features(serialize_core INTERFACE cxx_std_23)
+    target_link_libraries(serialize_core INTERFACE Threads::Threads)
+
+    add_library(serialize_instrumentation OBJECT EXCLUDE_FROM_ALL ${CMAKE_CURRENT_LIST_DIR}/src/serialize_instrumentation.cpp)
+    target_link_libraries(serialize_instrumentation PUBLIC serialize_core)
+endif()
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <iostream>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <iterator>
+#include <type_traits>
+
+#include "serialize_buffer.hpp"
+#include "serialize_encoding.hpp"
+
+/*
+Batch serialization of many objects in one pass. Calling serialize() for every small object
+pays for a call into the stream each time; these functions encode all the objects into one
+staging buffer of the exact size and hand it to the stream with a single write.
+
+    serialize_all(os, id, name, position, tags);
+    serialize_range(states.begin(), states.end(), os);
+
+    deserialize_all(is, id, name, position, tags);
+    deserialize_range(states.begin(), states.end(), is);
+
+The objects are written one after another in the format of serialize(), without a count, so
+serialize_all(os, a, b) writes the same bytes as serialize(a, os); serialize(b, os). The reading
+side can't know the total size in advance, so deserialize_all() reads the objects with one reader
+for the whole batch. A tuple is written with std::apply:
+    std::apply([&](const auto&... objs) { serialize_all(os, objs...); }, tuple);
+
+Like the other headers around the core, it uses the front-end included before it
+(serialize.hpp, serialize_concepts.hpp or serialize_sfinae.hpp).
+
+The target may be a std::ostream / std::istream or any writer / reader. The writer's encoding is
+used for the staging buffer, the aligned encoding is not supported (the padding depends on the
+position in the final stream).
+*/
+
+
+// Encodes the objects into a buffer of the exact size and writes it with one call
+template <typename Writer, typename Encode>
+void write_staged(Writer& w, std::size_t size, Encode&& encode)
+{
+    using Encoding = encoding_of_t<Writer>;
+    static_assert(!Encoding::aligned_blocks, "Batch serialization does not support the aligned encoding");
+
+    if (size == 0) return;
+
+    std::unique_ptr<std::byte[]> buffer(new std::byte[size]);
+    SpanWriter inner(std::span<std::byte>(buffer.get(), size));
+    EncodedWriter<Encoding, SpanWriter> staged(inner);
+    encode(staged);
+
+    w.write(buffer.get(), size);
+}
+
+
+
+template <typename Writer, typename... Ts>
+void serialize_all(Writer& w, const Ts&... objs)
+{
+    if constexpr (std::is_base_of_v<std::ostream, Writer>)
+    {
+        StreamWriter stream_writer(w);
+        serialize_all(stream_writer, objs...);
+    }
+    else
+    {
+        using Encoding = encoding_of_t<Writer>;
+        const std::size_t size = (std::size_t{0} + ... + serialized_size<Encoding>(objs));
+        write_staged(w, size, [&](auto& staged) { (serialize(objs, staged), ...); });
+    }
+}
+
+
+template <typename Iterator, typename Writer>
+void serialize_range(Iterator first, Iterator last, Writer& w)
+{
+    if constexpr (std::is_base_of_v<std::ostream, Writer>)
+    {
+        StreamWriter stream_writer(w);
+        serialize_range(first, last, stream_writer);
+    }
+    else
+    {
+        using Encoding = encoding_of_t<Writer>;
+        std::size_t size = 0;
+        for (Iterator it = first; it != last; ++it)
+            size += serialized_size<Encoding>(*it);
+
+        write_staged(w, size, [&](auto& staged) {
+            for (; first != last; ++first)
+                serialize(*first, staged);
+        });
+    }
+}
+
+
+
+template <typename Reader, typename... Ts>
+void deserialize_all(Reader& r, Ts&... objs)
+{
+    if constexpr (std::is_base_of_v<std::istream, Reader>)
+    {
+        StreamReader stream_reader(r);
+        deserialize_all(stream_reader, objs...);
+    }
+    else
+        (deserialize(objs, r), ...);
+}
+
+
+// Deserializes into the existing elements of [first, last)
+template <typename Iterator, typename Reader>
+void deserialize_range(Iterator first, Iterator last, Reader& r)
+{
+    if constexpr (std::is_base_of_v<std::istream, Reader>)
+    {
+        StreamReader stream_reader(r);
+        deserialize_range(first, last, stream_reader);
+    }
+    else
+    {
+        for (; first != last; ++first)
+            deserialize(*first, r);
+    }
+}
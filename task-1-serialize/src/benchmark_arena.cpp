@@ -0,0 +1,62 @@
+#include <gtest/gtest.h>
+
+#include <iostream>
+#include <cstddef>
+#include <vector>
+
+// #include <serialize_concepts.hpp>
+// #include <serialize_sfinae.hpp>
+#include "serialize.hpp"
+#include "my_vector.hpp"
+#include "monotonic_arena.hpp"
+#include "benchmark_utils.hpp"
+
+namespace
+{
+    constexpr std::size_t BENCHMARK_VECTORS = 1'000'000;
+}
+
+
+// Deserializes 1M small MyVector<int> and frees them, with the heap and with a MonotonicArena
+TEST(DISABLED_BenchmarkArena, SmallVectors1M)
+{
+    std::vector<std::byte> buffer;
+    {
+        MyVector<MyVector<int>> source;
+        source.reserve(BENCHMARK_VECTORS);
+        for (std::size_t i = 0; i < BENCHMARK_VECTORS; ++i)
+        {
+            MyVector<int>& vector = source.emplace_back();
+            for (std::size_t j = 0; j < 1 + i % 15; ++j)
+                vector.push_back(static_cast<int>(i + j));
+        }
+
+        buffer.reserve(serialized_size(source));
+        VectorWriter w(buffer);
+        serialize(source, w);
+    }
+
+    {
+        double seconds = measure_seconds([&] {
+            MyVector<MyVector<int>> result;
+            SpanReader r(buffer);
+            deserialize(result, r);
+            EXPECT_EQ(result.size(), BENCHMARK_VECTORS);
+        });
+        report("heap: deserialize and free", buffer.size(), seconds);
+    }
+
+    {
+        MonotonicArena arena;
+        double seconds = measure_seconds([&] {
+            {
+                PmrMyVector<PmrMyVector<int>> result(&arena);
+                SpanReader r(buffer);
+                deserialize(result, r);
+                EXPECT_EQ(result.size(), BENCHMARK_VECTORS);
+            }
+            arena.release();
+        });
+        report("arena: deserialize and free", buffer.size(), seconds);
+    }
+}
@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <cstddef>
+#include <vector>
+#include <string>
+
+// #include <serialize_concepts.hpp>
+// #include <serialize_sfinae.hpp>
+#include "serialize.hpp"
+#include "batch_serialize.hpp"
+#include "benchmark_utils.hpp"
+
+namespace
+{
+    constexpr std::size_t BENCHMARK_OBJECTS = 500'000;
+}
+
+
+TEST(DISABLED_BenchmarkBatch, SmallObjects500K)
+{
+    std::vector<std::pair<int, std::string>> states;
+    states.reserve(BENCHMARK_OBJECTS);
+    for (std::size_t i = 0; i < BENCHMARK_OBJECTS; ++i)
+        states.emplace_back(static_cast<int>(i), "state " + std::to_string(i));
+
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "serialize_benchmark_batch.bin";
+
+    // The default buffer of std::filebuf: every serialize() copies into it and flushes it when it is full
+    {
+        std::ofstream ofs(path, std::ios::binary);
+        double seconds = measure_seconds([&] {
+            for (const auto& state : states)
+                serialize(state, ofs);
+            ofs.flush();
+        });
+        report("serialize() per object (before)", std::filesystem::file_size(path), seconds);
+    }
+
+    {
+        std::ofstream ofs(path, std::ios::binary);
+        double seconds = measure_seconds([&] {
+            serialize_range(states.begin(), states.end(), ofs);
+            ofs.flush();
+        });
+        report("serialize_range (after)", std::filesystem::file_size(path), seconds);
+    }
+
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+
+#include <iostream>
+#include <cstddef>
+#include <vector>
+#include <map>
+#include <string>
+
+// #include <serialize_concepts.hpp>
+// #include <serialize_sfinae.hpp>
+#include "serialize.hpp"
+#include "block_compression.hpp"
+#include "benchmark_utils.hpp"
+
+namespace
+{
+    constexpr int BENCHMARK_ENTRIES = 2'000'000;
+}
+
+
+TEST(DISABLED_BenchmarkCompression, MapOfStringToInt)
+{
+    std::map<std::string, int> mp;
+    for (int i = 0; i < BENCHMARK_ENTRIES; ++i)
+        mp["user.settings.option_" + std::to_string(i)] = i % 10;
+    const std::size_t raw_size = serialized_size(mp);
+
+    std::vector<std::byte> plain;
+    {
+        plain.reserve(raw_size);
+        VectorWriter w(plain);
+        double seconds = measure_seconds([&] { serialize(mp, w); });
+        report("serialize (uncompressed)", raw_size, seconds);
+    }
+    {
+        // The first load also pays for growing the heap, so it is not measured
+        std::map<std::string, int> warm_up;
+        SpanReader warm_up_reader(plain);
+        deserialize(warm_up, warm_up_reader);
+    }
+    {
+        std::map<std::string, int> result;
+        SpanReader r(plain);
+        double seconds = measure_seconds([&] { deserialize(result, r); });
+        report("deserialize (uncompressed)", raw_size, seconds);
+    }
+
+    std::vector<std::byte> compressed;
+    {
+        VectorWriter inner(compressed);
+        double seconds = measure_seconds([&] {
+            CompressedWriter w(inner);
+            serialize(mp, w);
+        });
+        report("serialize (compressed)", raw_size, seconds);
+        std::cout << "[ BENCH    ] compression ratio: " << static_cast<double>(compressed.size()) / raw_size << std::endl;
+    }
+    {
+        std::map<std::string, int> result;
+        SpanReader inner(compressed);
+        CompressedReader r(inner);
+        double seconds = measure_seconds([&] { deserialize(result, r); });
+        report("deserialize (compressed, streaming)", raw_size, seconds);
+        EXPECT_EQ(result, mp);
+    }
+
+    for (std::size_t threads = 1; threads <= default_thread_count(); threads *= 2)
+    {
+        std::vector<std::byte> decompressed;
+        double seconds = measure_seconds([&] { decompressed = decompress_parallel(compressed, threads); });
+        report("decompress_parallel, " + std::to_string(threads) + " threads", raw_size, seconds);
+        EXPECT_EQ(decompressed, plain);
+    }
+}
@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+
+#include <iostream>
+#include <cstddef>
+#include <vector>
+#include <map>
+#include <string>
+
+// #include <serialize_concepts.hpp>
+// #include <serialize_sfinae.hpp>
+#include "serialize.hpp"
+#include "benchmark_utils.hpp"
+
+namespace
+{
+    constexpr int BENCHMARK_ENTRIES = 1'000'000;
+
+    template <typename Encoding, typename T>
+    void run_encoding_benchmark(const std::string& name, const T& obj)
+    {
+        std::vector<std::byte> buffer;
+        buffer.reserve(serialized_size<Encoding>(obj));
+
+        double seconds = measure_seconds([&] {
+            VectorWriter inner(buffer);
+            auto w = with_encoding<Encoding>(inner);
+            serialize(obj, w);
+        });
+        report(name + " serialize (" + std::to_string(buffer.size()) + " bytes)", buffer.size(), seconds);
+
+        T result{};
+        seconds = measure_seconds([&] {
+            SpanReader inner(buffer);
+            auto r = with_decoding<Encoding>(inner);
+            deserialize(result, r);
+        });
+        report(name + " deserialize", buffer.size(), seconds);
+
+        EXPECT_EQ(obj, result);
+    }
+}
+
+
+TEST(DISABLED_BenchmarkEncoding, MapOfSmallStrings)
+{
+    std::map<std::string, int> m;
+    for (int i = 0; i < BENCHMARK_ENTRIES; ++i)
+        m.emplace("k" + std::to_string(i), i % 100);
+
+    run_encoding_benchmark<FixedEncoding>("fixed", m);
+    run_encoding_benchmark<VarintEncoding>("varint", m);
+}
+
+TEST(DISABLED_BenchmarkEncoding, VectorOfSmallInts)
+{
+    std::vector<int> vec(BENCHMARK_ENTRIES);
+    for (int i = 0; i < BENCHMARK_ENTRIES; ++i)
+        vec[i] = (i % 200) - 100;
+
+    run_encoding_benchmark<FixedEncoding>("fixed", vec);
+    run_encoding_benchmark<VarintEncoding>("varint", vec);
+}
+
+TEST(DISABLED_BenchmarkEncoding, VectorOfUint32ByteOrder)
+{
+    std::vector<uint32_t> vec(16 * BENCHMARK_ENTRIES);
+    for (std::size_t i = 0; i < vec.size(); ++i)
+        vec[i] = static_cast<uint32_t>(i * 2654435761u);
+
+    // The same bytes as fixed on little-endian hosts, the big-endian one goes through the SIMD byte swap
+    run_encoding_benchmark<FixedEncoding>("fixed", vec);
+    run_encoding_benchmark<LittleEndianEncoding>("little-endian", vec);
+    run_encoding_benchmark<BigEndianEncoding>("big-endian", vec);
+}
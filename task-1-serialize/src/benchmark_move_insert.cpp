@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+
+#include <iostream>
+#include <cstddef>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <string>
+
+// #include <serialize_concepts.hpp>
+// #include <serialize_sfinae.hpp>
+#include "serialize.hpp"
+#include "benchmark_utils.hpp"
+
+namespace
+{
+    constexpr std::size_t BENCHMARK_ENTRIES = 10'000'000;
+
+    // The previous implementation of the map deserializer: copies every pair into the map without a hint or reserve()
+    template <typename Map, typename Reader>
+    void deserialize_map_copying(Map& c, Reader& r)
+    {
+        c.clear();
+        uint32_t len = read_length(r);
+        for (uint32_t i = 0; i < len; i++)
+        {
+            typename Map::value_type obj{};
+            deserialize(obj, r);
+            c.insert(obj);
+        }
+    }
+}
+
+
+TEST(DISABLED_BenchmarkMoveInsert, MapOfStringToVector10M)
+{
+    std::vector<std::byte> buffer;
+    {
+        std::map<std::string, std::vector<int>> mp;
+        for (std::size_t i = 0; i < BENCHMARK_ENTRIES; ++i)
+            mp.emplace_hint(mp.end(), "key-" + std::to_string(1'000'000'000 + i), std::vector<int>(i % 8, static_cast<int>(i)));
+
+        buffer.reserve(serialized_size(mp));
+        VectorWriter w(buffer);
+        serialize(mp, w);
+    }
+
+    {
+        std::map<std::string, std::vector<int>> result;
+        SpanReader r(buffer);
+        double seconds = measure_seconds([&] { deserialize_map_copying(result, r); });
+        report("copying insert (before)", buffer.size(), seconds);
+        EXPECT_EQ(result.size(), BENCHMARK_ENTRIES);
+    }
+
+    {
+        std::map<std::string, std::vector<int>> result;
+        SpanReader r(buffer);
+        double seconds = measure_seconds([&] { deserialize(result, r); });
+        report("deserialize (after)", buffer.size(), seconds);
+        EXPECT_EQ(result.size(), BENCHMARK_ENTRIES);
+    }
+}
+
+TEST(DISABLED_BenchmarkMoveInsert, UnorderedMapOfStringToInt10M)
+{
+    std::vector<std::byte> buffer;
+    {
+        std::unordered_map<std::string, int> mp;
+        mp.reserve(BENCHMARK_ENTRIES);
+        for (std::size_t i = 0; i < BENCHMARK_ENTRIES; ++i)
+            mp.emplace("key-" + std::to_string(1'000'000'000 + i), static_cast<int>(i));
+
+        buffer.reserve(serialized_size(mp));
+        VectorWriter w(buffer);
+        serialize(mp, w);
+    }
+
+    {
+        std::unordered_map<std::string, int> result;
+        SpanReader r(buffer);
+        double seconds = measure_seconds([&] { deserialize_map_copying(result, r); });
+        report("copying insert, rehashing (before)", buffer.size(), seconds);
+        EXPECT_EQ(result.size(), BENCHMARK_ENTRIES);
+    }
+
+    {
+        std::unordered_map<std::string, int> result;
+        SpanReader r(buffer);
+        double seconds = measure_seconds([&] { deserialize(result, r); });
+        report("deserialize (after)", buffer.size(), seconds);
+        EXPECT_EQ(result.size(), BENCHMARK_ENTRIES);
+    }
+}
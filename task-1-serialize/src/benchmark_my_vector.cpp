@@ -0,0 +1,201 @@
+#include <gtest/gtest.h>
+
+#include <iostream>
+#include <cstddef>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cstdint>
+
+// #include <serialize_concepts.hpp>
+// #include <serialize_sfinae.hpp>
+#include "serialize.hpp"
+#include "my_vector.hpp"
+#include "benchmark_utils.hpp"
+
+namespace
+{
+    constexpr std::size_t BENCHMARK_INTS = 50'000'000;
+    constexpr std::size_t BENCHMARK_STRINGS = 5'000'000;
+    constexpr std::size_t BENCHMARK_SMALL_VECTORS = 1'000'000;
+    constexpr std::size_t BENCHMARK_SEARCH_VALUES = 64'000'000;
+    constexpr std::size_t BENCHMARK_COMPARED_VECTORS = 1'000'000;
+
+    // Long enough not to fit into the small string buffer, so a copy allocates
+    std::string long_string(std::size_t i)
+    {
+        return "a string that doesn't fit into SSO, number " + std::to_string(i);
+    }
+
+    // The element-by-element versions the members replaced
+    template <typename T>
+    bool scalar_equal(const MyVector<T>& first, const MyVector<T>& second)
+    {
+        if (first.size() != second.size()) return false;
+        for (std::size_t i = 0; i < first.size(); ++i)
+            if (first[i] != second[i]) return false;
+        return true;
+    }
+
+    template <typename T>
+    std::size_t scalar_find(const MyVector<T>& vector, T value)
+    {
+        for (std::size_t i = 0; i < vector.size(); ++i)
+            if (vector[i] == value) return i;
+        return vector.size();
+    }
+
+    // Grows the vector from empty with push_back only, so every doubling goes through reserve()
+    template <typename Vector, typename Make>
+    void grow(Vector& vector, std::size_t count, Make&& make)
+    {
+        for (std::size_t i = 0; i < count; ++i)
+            vector.push_back(make(i));
+    }
+}
+
+
+TEST(DISABLED_BenchmarkMyVector, GrowInts50M)
+{
+    auto make = [](std::size_t i) { return static_cast<int>(i); };
+
+    {
+        std::vector<int> vector;
+        double seconds = measure_seconds([&] { grow(vector, BENCHMARK_INTS, make); });
+        report("std::vector<int>", BENCHMARK_INTS * sizeof(int), seconds);
+        EXPECT_EQ(vector.size(), BENCHMARK_INTS);
+    }
+
+    {
+        MyVector<int> vector;
+        double seconds = measure_seconds([&] { grow(vector, BENCHMARK_INTS, make); });
+        report("MyVector<int>", BENCHMARK_INTS * sizeof(int), seconds);
+        EXPECT_EQ(vector.size(), BENCHMARK_INTS);
+    }
+}
+
+TEST(DISABLED_BenchmarkMyVector, GrowStrings5M)
+{
+    std::vector<std::string> strings;
+    strings.reserve(BENCHMARK_STRINGS);
+    std::size_t bytes = 0;
+    for (std::size_t i = 0; i < BENCHMARK_STRINGS; ++i)
+    {
+        strings.push_back(long_string(i));
+        bytes += strings.back().size();
+    }
+    auto make = [&](std::size_t i) { return strings[i]; };
+
+    {
+        std::vector<std::string> vector;
+        double seconds = measure_seconds([&] { grow(vector, BENCHMARK_STRINGS, make); });
+        report("std::vector<std::string>", bytes, seconds);
+        EXPECT_EQ(vector.size(), BENCHMARK_STRINGS);
+    }
+
+    {
+        MyVector<std::string> vector;
+        double seconds = measure_seconds([&] { grow(vector, BENCHMARK_STRINGS, make); });
+        report("MyVector<std::string>", bytes, seconds);
+        EXPECT_EQ(vector.size(), BENCHMARK_STRINGS);
+    }
+}
+
+// 1M vectors of 1-15 ints: one heap block each for MyVector, none for SmallVector<int, 16>
+TEST(DISABLED_BenchmarkMyVector, DeserializeSmallVectors1M)
+{
+    std::vector<std::byte> buffer;
+    {
+        MyVector<MyVector<int>> source;
+        source.reserve(BENCHMARK_SMALL_VECTORS);
+        for (std::size_t i = 0; i < BENCHMARK_SMALL_VECTORS; ++i)
+        {
+            MyVector<int>& vector = source.emplace_back();
+            for (std::size_t j = 0; j < 1 + i % 15; ++j)
+                vector.push_back(static_cast<int>(i + j));
+        }
+
+        buffer.reserve(serialized_size(source));
+        VectorWriter w(buffer);
+        serialize(source, w);
+    }
+
+    {
+        double seconds = measure_seconds([&] {
+            MyVector<MyVector<int>> result;
+            SpanReader r(buffer);
+            deserialize(result, r);
+            EXPECT_EQ(result.size(), BENCHMARK_SMALL_VECTORS);
+        });
+        report("MyVector<int>: deserialize and free", buffer.size(), seconds);
+    }
+
+    {
+        double seconds = measure_seconds([&] {
+            MyVector<SmallVector<int, 16>> result;
+            SpanReader r(buffer);
+            deserialize(result, r);
+            EXPECT_EQ(result.size(), BENCHMARK_SMALL_VECTORS);
+        });
+        report("SmallVector<int, 16>: deserialize and free", buffer.size(), seconds);
+    }
+}
+
+TEST(DISABLED_BenchmarkMyVector, SearchUint32_64M)
+{
+    MyVector<uint32_t> vector;
+    vector.reserve(BENCHMARK_SEARCH_VALUES);
+    for (std::size_t i = 0; i < BENCHMARK_SEARCH_VALUES; ++i)
+        vector.push_back(static_cast<uint32_t>(i % 1000));
+    const uint32_t absent = 5000;
+    const std::size_t bytes = BENCHMARK_SEARCH_VALUES * sizeof(uint32_t);
+
+    std::size_t index = 0;
+    double seconds = measure_seconds([&] { index = scalar_find(vector, absent); });
+    report("find, scalar loop", bytes, seconds);
+    EXPECT_EQ(index, vector.size());
+
+    seconds = measure_seconds([&] { index = static_cast<std::size_t>(vector.find(absent) - vector.begin()); });
+    report("find, MyVector::find", bytes, seconds);
+    EXPECT_EQ(index, vector.size());
+
+    std::size_t count = 0;
+    seconds = measure_seconds([&] { count = static_cast<std::size_t>(std::count(vector.begin(), vector.end(), 7u)); });
+    report("count, std::count", bytes, seconds);
+    EXPECT_EQ(count, BENCHMARK_SEARCH_VALUES / 1000);
+
+    seconds = measure_seconds([&] { count = vector.count(7u); });
+    report("count, MyVector::count", bytes, seconds);
+    EXPECT_EQ(count, BENCHMARK_SEARCH_VALUES / 1000);
+}
+
+// Dedup step: every vector is compared with an equal one, so all elements are read
+TEST(DISABLED_BenchmarkMyVector, CompareVectorsUint32_1M)
+{
+    MyVector<MyVector<uint32_t>> vectors;
+    vectors.reserve(BENCHMARK_COMPARED_VECTORS);
+    for (std::size_t i = 0; i < BENCHMARK_COMPARED_VECTORS; ++i)
+    {
+        MyVector<uint32_t>& vector = vectors.emplace_back();
+        for (std::size_t j = 0; j < 64; ++j)
+            vector.push_back(static_cast<uint32_t>(i * j));
+    }
+    const MyVector<MyVector<uint32_t>> copies = vectors;
+    const std::size_t bytes = BENCHMARK_COMPARED_VECTORS * 64 * sizeof(uint32_t);
+
+    std::size_t equal = 0;
+    double seconds = measure_seconds([&] {
+        for (std::size_t i = 0; i < vectors.size(); ++i)
+            equal += scalar_equal(vectors[i], copies[i]) ? 1 : 0;
+    });
+    report("scalar loop", bytes, seconds);
+    EXPECT_EQ(equal, BENCHMARK_COMPARED_VECTORS);
+
+    equal = 0;
+    seconds = measure_seconds([&] {
+        for (std::size_t i = 0; i < vectors.size(); ++i)
+            equal += vectors[i] == copies[i] ? 1 : 0;
+    });
+    report("operator==", bytes, seconds);
+    EXPECT_EQ(equal, BENCHMARK_COMPARED_VECTORS);
+}
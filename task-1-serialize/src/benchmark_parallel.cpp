@@ -0,0 +1,55 @@
+#include <gtest/gtest.h>
+
+#include <iostream>
+#include <cstddef>
+#include <vector>
+#include <string>
+
+// #include <serialize_concepts.hpp>
+// #include <serialize_sfinae.hpp>
+#include "serialize.hpp"
+#include "parallel_serialize.hpp"
+#include "benchmark_utils.hpp"
+
+namespace
+{
+    constexpr std::size_t BENCHMARK_STRINGS = 5'000'000;
+}
+
+
+TEST(DISABLED_BenchmarkParallel, VectorOfStringsScaling)
+{
+    std::vector<std::string> vec;
+    vec.reserve(BENCHMARK_STRINGS);
+    for (std::size_t i = 0; i < BENCHMARK_STRINGS; ++i)
+        vec.push_back("benchmark string " + std::to_string(i));
+
+    std::vector<std::byte> plain;
+    {
+        plain.reserve(serialized_size(vec));
+        VectorWriter w(plain);
+        double seconds = measure_seconds([&] { serialize(vec, w); });
+        report("serialize (single-threaded)", plain.size(), seconds);
+    }
+
+    for (std::size_t threads = 1; threads <= default_thread_count(); threads *= 2)
+    {
+        // Both buffers are reserved, so only the encoding is measured: the elements, the header and the chunk index
+        std::vector<std::byte> buffer;
+        buffer.reserve(plain.size() + sizeof(uint32_t) * 2 + (sizeof(uint32_t) + sizeof(uint64_t)) * threads * DEFAULT_PARALLEL_CHUNKS_PER_THREAD);
+        double seconds = measure_seconds([&] {
+            VectorWriter w(buffer);
+            serialize_parallel(vec, w, threads);
+        });
+        report("serialize_parallel, " + std::to_string(threads) + " threads", buffer.size(), seconds);
+
+        std::vector<std::string> result;
+        seconds = measure_seconds([&] {
+            SpanReader r(buffer);
+            deserialize_parallel(result, r, threads);
+        });
+        report("deserialize_parallel, " + std::to_string(threads) + " threads", buffer.size(), seconds);
+
+        EXPECT_EQ(vec, result);
+    }
+}
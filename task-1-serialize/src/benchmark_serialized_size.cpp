@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+
+#include <iostream>
+#include <sstream>
+#include <cstddef>
+#include <vector>
+#include <map>
+#include <string>
+
+// #include <serialize_concepts.hpp>
+// #include <serialize_sfinae.hpp>
+#include "serialize.hpp"
+#include "benchmark_utils.hpp"
+
+namespace
+{
+    constexpr int BENCHMARK_MAP_SIZE = 1'000'000;
+
+    // VectorWriter that counts how many times the buffer was reallocated
+    class CountingVectorWriter
+    {
+    public:
+        explicit CountingVectorWriter(std::vector<std::byte>& buffer) : m_buffer(buffer), m_writer(buffer) {}
+
+        void write(const std::byte* data, std::size_t size)
+        {
+            const std::size_t capacity = m_buffer.capacity();
+            m_writer.write(data, size);
+            if (m_buffer.capacity() != capacity) ++m_reallocations;
+        }
+
+        std::size_t reallocations() const { return m_reallocations; }
+
+    private:
+        std::vector<std::byte>& m_buffer;
+        VectorWriter m_writer;
+        std::size_t m_reallocations = 0;
+    };
+}
+
+
+TEST(DISABLED_BenchmarkSerializedSize, MapIntToString1M)
+{
+    std::map<int, std::string> m;
+    for (int i = 0; i < BENCHMARK_MAP_SIZE; ++i)
+        m.emplace(i, "value_" + std::to_string(i * 7));
+
+    std::size_t bytes = 0;
+    double seconds = measure_seconds([&] { bytes = serialized_size(m); });
+    report("serialized_size", bytes, seconds);
+
+    {
+        std::ostringstream oss(std::stringstream::binary);
+        seconds = measure_seconds([&] { serialize(m, oss); });
+        report("std::ostringstream", bytes, seconds);
+    }
+
+    std::vector<std::byte> grown;
+    {
+        CountingVectorWriter w(grown);
+        seconds = measure_seconds([&] { serialize(m, w); });
+        report("VectorWriter, growing (" + std::to_string(w.reallocations()) + " reallocations)", bytes, seconds);
+    }
+
+    std::vector<std::byte> reserved;
+    {
+        CountingVectorWriter w(reserved);
+        seconds = measure_seconds([&] {
+            reserved.reserve(serialized_size(m));
+            serialize(m, w);
+        });
+        report("VectorWriter, reserve(serialized_size) (" + std::to_string(w.reallocations()) + " reallocations)", bytes, seconds);
+        EXPECT_EQ(w.reallocations(), 0u);
+    }
+
+    EXPECT_EQ(grown, reserved);
+    EXPECT_EQ(reserved.size(), bytes);
+}
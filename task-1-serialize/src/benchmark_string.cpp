@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <iterator>
+#include <algorithm>
+
+// #include <serialize_concepts.hpp>
+// #include <serialize_sfinae.hpp>
+#include "serialize.hpp"
+#include "benchmark_utils.hpp"
+
+namespace
+{
+    constexpr size_t BENCHMARK_STRING_SIZE = 100 * 1024 * 1024;
+
+    std::string make_benchmark_payload()
+    {
+        std::string str(BENCHMARK_STRING_SIZE, '\0');
+        for (size_t i = 0; i < str.size(); ++i)
+            str[i] = static_cast<char>(i * 31 % 251);
+
+        std::ostringstream oss(std::stringstream::binary);
+        serialize(str, oss);
+        return oss.str();
+    }
+
+    // The previous implementation of the string deserializer: formatted reads byte by byte
+    void deserialize_string_formatted(std::string& str, std::istream& is)
+    {
+        uint32_t len = 0;
+        std::istream_iterator<uint8_t> len_ii(is);
+        std::copy_n(len_ii, sizeof(len), reinterpret_cast<uint8_t*>(&len));
+
+        str.clear();
+        str.resize(len);
+        std::istream_iterator<char> ii(is);
+        std::copy_n(ii, static_cast<size_t>(len), str.data());
+    }
+}
+
+
+TEST(DISABLED_BenchmarkString, Deserialize100MB)
+{
+    const std::string payload = make_benchmark_payload();
+
+    std::string formatted_result;
+    {
+        std::istringstream iss(payload, std::stringstream::binary);
+        iss >> std::noskipws;
+        double seconds = measure_seconds([&] { deserialize_string_formatted(formatted_result, iss); });
+        report("istream_iterator (before)", BENCHMARK_STRING_SIZE, seconds);
+    }
+
+    std::string unformatted_result;
+    {
+        std::istringstream iss(payload, std::stringstream::binary);
+        double seconds = measure_seconds([&] { deserialize(unformatted_result, iss); });
+        report("deserialize (after)", BENCHMARK_STRING_SIZE, seconds);
+    }
+
+    EXPECT_EQ(formatted_result, unformatted_result);
+}
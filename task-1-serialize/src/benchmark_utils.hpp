@@ -0,0 +1,25 @@
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <chrono>
+
+/*
+Helpers for the micro-benchmarks. The benchmarks are disabled tests, run them with:
+./bin/tests_concepts --gtest_also_run_disabled_tests --gtest_filter=*Benchmark*
+*/
+
+template <typename Function>
+double measure_seconds(Function&& function)
+{
+    auto start = std::chrono::steady_clock::now();
+    function();
+    auto finish = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(finish - start).count();
+}
+
+inline void report(const std::string& name, std::size_t bytes, double seconds)
+{
+    std::cout << "[ BENCH    ] " << name << ": " << seconds * 1000.0 << " ms, " 
+              << bytes / seconds / (1024.0 * 1024.0) << " MB/s" << std::endl;
+}
@@ -0,0 +1,441 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <span>
+#include <string>
+#include <algorithm>
+
+#include "serialize_buffer.hpp"
+#include "serialize_encoding.hpp"
+#include "parallel_serialize.hpp"
+
+/*
+Block-compressed streams. CompressedWriter collects the serialized bytes into blocks of a fixed
+size, compresses every block with a small LZ77 codec (the LZ4 sequence format) and writes it to
+another writer. CompressedReader reads the blocks back one by one, decompress_parallel()
+decompresses a whole compressed buffer on several threads, because every block is independent.
+
+    std::vector<std::byte> buffer;
+    VectorWriter inner(buffer);
+    {
+        CompressedWriter w(inner);
+        serialize(big_map, w);
+    }   // or w.finish()
+
+    SpanReader inner_reader(buffer);
+    CompressedReader r(inner_reader);
+    deserialize(big_map, r);
+    r.finish();         // reads the end of the stream, the next data of inner_reader can follow
+
+Format: a sequence of blocks, every block is (the numbers are little-endian on every host)
+    uint32_t  number of bytes before compression (0 ends the stream)
+    uint32_t  number of stored bytes, the high bit is set if the block is stored without compression
+    the stored bytes
+
+Compressed block: a sequence of LZ4-style sequences. A sequence is a token byte (high 4 bits:
+number of literals, low 4 bits: match length - 4, 15 means "more length bytes follow", every
+following byte is added until a byte is not 255), the literals, a uint16_t little-endian offset
+of the match back from the current position, and the extra match length bytes. The last sequence
+of a block has only literals.
+
+The writer and the reader keep the encoding of the writer/reader they wrap.
+*/
+
+
+constexpr std::size_t DEFAULT_COMPRESSION_BLOCK_SIZE = 64 * 1024;
+
+constexpr std::size_t LZ_MIN_MATCH = 4;
+constexpr std::size_t LZ_MAX_OFFSET = 65535;
+constexpr std::size_t LZ_HASH_BITS = 14;
+
+constexpr uint32_t STORED_BLOCK_FLAG = 0x80000000u;
+constexpr std::size_t COMPRESSED_BLOCK_HEADER_SIZE = 2 * sizeof(uint32_t);
+
+
+
+//=========================================CODEC=========================================
+
+inline uint32_t lz_load32(const std::byte* ptr)
+{
+    uint32_t value = 0;
+    std::memcpy(&value, ptr, sizeof(value));
+    return value;
+}
+
+// Block headers: the size before compression and the stored size, little-endian
+inline void store_block_header(std::byte* out, uint32_t raw_size, uint32_t stored_size)
+{
+    if constexpr (needs_byte_swap<uint32_t, LittleEndianEncoding>)
+    {
+        raw_size = byte_swap_value(raw_size);
+        stored_size = byte_swap_value(stored_size);
+    }
+    std::memcpy(out, &raw_size, sizeof(raw_size));
+    std::memcpy(out + sizeof(raw_size), &stored_size, sizeof(stored_size));
+}
+
+inline void load_block_header(const std::byte* in, uint32_t& raw_size, uint32_t& stored_size)
+{
+    std::memcpy(&raw_size, in, sizeof(raw_size));
+    std::memcpy(&stored_size, in + sizeof(raw_size), sizeof(stored_size));
+    if constexpr (needs_byte_swap<uint32_t, LittleEndianEncoding>)
+    {
+        raw_size = byte_swap_value(raw_size);
+        stored_size = byte_swap_value(stored_size);
+    }
+}
+
+inline uint32_t lz_hash(uint32_t sequence)
+{
+    return (sequence * 2654435761u) >> (32 - LZ_HASH_BITS);
+}
+
+inline void lz_write_length(std::vector<std::byte>& out, std::size_t length)
+{
+    while (length >= 255)
+    {
+        out.push_back(std::byte{255});
+        length -= 255;
+    }
+    out.push_back(static_cast<std::byte>(length));
+}
+
+inline std::size_t lz_read_length(const std::byte*& ip, const std::byte* end)
+{
+    std::size_t length = 0;
+    uint8_t byte = 255;
+    while (byte == 255)
+    {
+        if (ip == end) throw SerializeBufferError("Invalid compressed block: unexpected end of a length.");
+        byte = std::to_integer<uint8_t>(*ip++);
+        length += byte;
+    }
+    return length;
+}
+
+inline void lz_write_sequence(std::vector<std::byte>& out, const std::byte* literals, std::size_t literal_count,
+                              std::size_t offset, std::size_t match_length)
+{
+    const std::size_t match_code = match_length >= LZ_MIN_MATCH ? match_length - LZ_MIN_MATCH : 0;
+    const uint8_t token = static_cast<uint8_t>((std::min<std::size_t>(literal_count, 15) << 4) | std::min<std::size_t>(match_code, 15));
+    out.push_back(static_cast<std::byte>(token));
+
+    if (literal_count >= 15) lz_write_length(out, literal_count - 15);
+    out.insert(out.end(), literals, literals + literal_count);
+
+    if (match_length == 0) return;
+    out.push_back(static_cast<std::byte>(offset & 0xFF));
+    out.push_back(static_cast<std::byte>(offset >> 8));
+    if (match_code >= 15) lz_write_length(out, match_code - 15);
+}
+
+
+// Appends the compressed form of the block to `out`. `table` is reused between the calls
+inline void lz_compress_block(std::span<const std::byte> block, std::vector<std::byte>& out, std::vector<uint32_t>& table)
+{
+    constexpr uint32_t EMPTY = 0xFFFFFFFFu;
+    table.assign(std::size_t{1} << LZ_HASH_BITS, EMPTY);
+
+    const std::byte* src = block.data();
+    const std::size_t size = block.size();
+    std::size_t anchor = 0;
+    std::size_t ip = 0;
+
+    while (ip + LZ_MIN_MATCH <= size)
+    {
+        const uint32_t sequence = lz_load32(src + ip);
+        uint32_t& slot = table[lz_hash(sequence)];
+        const std::size_t candidate = slot;
+        slot = static_cast<uint32_t>(ip);
+
+        if (candidate == EMPTY || ip - candidate > LZ_MAX_OFFSET || lz_load32(src + candidate) != sequence)
+        {
+            ++ip;
+            continue;
+        }
+
+        std::size_t match_length = LZ_MIN_MATCH;
+        while (ip + match_length < size && src[candidate + match_length] == src[ip + match_length])
+            ++match_length;
+
+        lz_write_sequence(out, src + anchor, ip - anchor, ip - candidate, match_length);
+        ip += match_length;
+        anchor = ip;
+    }
+
+    // The last sequence has only literals
+    lz_write_sequence(out, src + anchor, size - anchor, 0, 0);
+}
+
+
+// Decompresses a block into exactly out.size() bytes, throws SerializeBufferError on invalid data
+inline void lz_decompress_block(std::span<const std::byte> block, std::span<std::byte> out)
+{
+    const std::byte* ip = block.data();
+    const std::byte* const end = ip + block.size();
+    std::byte* op = out.data();
+    std::byte* const out_end = op + out.size();
+
+    while (ip < end)
+    {
+        const uint8_t token = std::to_integer<uint8_t>(*ip++);
+
+        std::size_t literal_count = token >> 4;
+        if (literal_count == 15) literal_count += lz_read_length(ip, end);
+        if (literal_count > static_cast<std::size_t>(end - ip) || literal_count > static_cast<std::size_t>(out_end - op))
+            throw SerializeBufferError("Invalid compressed block: literals out of bounds.");
+        // An empty block still has a token, and its output may be a null pointer
+        if (literal_count > 0) std::memcpy(op, ip, literal_count);
+        ip += literal_count;
+        op += literal_count;
+
+        if (ip == end) break;
+
+        if (end - ip < 2) throw SerializeBufferError("Invalid compressed block: unexpected end of an offset.");
+        const std::size_t offset = std::to_integer<std::size_t>(ip[0]) | (std::to_integer<std::size_t>(ip[1]) << 8);
+        ip += 2;
+
+        std::size_t match_length = (token & 0x0F) + LZ_MIN_MATCH;
+        if ((token & 0x0F) == 15) match_length += lz_read_length(ip, end);
+
+        if (offset == 0 || offset > static_cast<std::size_t>(op - out.data()) || match_length > static_cast<std::size_t>(out_end - op))
+            throw SerializeBufferError("Invalid compressed block: match out of bounds.");
+
+        // An overlapping match repeats the bytes it has just written, so it is copied byte by byte
+        const std::byte* match = op - offset;
+        if (offset >= match_length)
+            std::memcpy(op, match, match_length);
+        else
+            for (std::size_t i = 0; i < match_length; ++i)
+                op[i] = match[i];
+        op += match_length;
+    }
+
+    if (op != out_end) throw SerializeBufferError("Invalid compressed block: wrong decompressed size.");
+}
+
+
+
+//=====================================WRITER/READER=====================================
+
+template <typename Writer>
+class CompressedWriter
+{
+public:
+    using encoding = encoding_of_t<Writer>;
+
+    explicit CompressedWriter(Writer& writer, std::size_t block_size = DEFAULT_COMPRESSION_BLOCK_SIZE)
+        : m_writer(writer), m_block_size(block_size > 0 ? block_size : DEFAULT_COMPRESSION_BLOCK_SIZE)
+    {
+        m_block.reserve(m_block_size);
+    }
+
+    CompressedWriter(const CompressedWriter&) = delete;
+    CompressedWriter& operator=(const CompressedWriter&) = delete;
+
+    ~CompressedWriter()
+    {
+        try
+        {
+            finish();
+        }
+        catch (...) {}
+    }
+
+    void write(const std::byte* data, std::size_t size)
+    {
+        if (m_finished) throw SerializeBufferError("Cannot write to a finished CompressedWriter.");
+
+        while (size > 0)
+        {
+            const std::size_t count = std::min(size, m_block_size - m_block.size());
+            m_block.insert(m_block.end(), data, data + count);
+            data += count;
+            size -= count;
+            m_position += count;
+
+            if (m_block.size() == m_block_size) flush_block();
+        }
+    }
+
+    // Bytes written before compression
+    std::size_t position() const { return m_position; }
+
+    // Writes the last block and the end of the stream
+    void finish()
+    {
+        if (m_finished) return;
+        m_finished = true;
+
+        if (!m_block.empty()) flush_block();
+        std::byte end_of_stream[COMPRESSED_BLOCK_HEADER_SIZE];
+        store_block_header(end_of_stream, 0, 0);
+        m_writer.write(end_of_stream, sizeof(end_of_stream));
+    }
+
+private:
+    void flush_block()
+    {
+        m_compressed.clear();
+        lz_compress_block(m_block, m_compressed, m_table);
+
+        // Blocks that don't get smaller are stored as they are
+        const bool stored = m_compressed.size() >= m_block.size();
+        const std::vector<std::byte>& payload = stored ? m_block : m_compressed;
+
+        std::byte header[COMPRESSED_BLOCK_HEADER_SIZE];
+        store_block_header(header, static_cast<uint32_t>(m_block.size()),
+                           static_cast<uint32_t>(payload.size()) | (stored ? STORED_BLOCK_FLAG : 0));
+        m_writer.write(header, sizeof(header));
+        m_writer.write(payload.data(), payload.size());
+
+        m_block.clear();
+    }
+
+    Writer& m_writer;
+    std::size_t m_block_size;
+    std::size_t m_position = 0;
+    bool m_finished = false;
+
+    std::vector<std::byte> m_block;
+    std::vector<std::byte> m_compressed;
+    std::vector<uint32_t> m_table;
+};
+
+
+template <typename Reader>
+class CompressedReader
+{
+public:
+    using encoding = encoding_of_t<Reader>;
+
+    explicit CompressedReader(Reader& reader) : m_reader(reader) {}
+
+    void read(std::byte* data, std::size_t size)
+    {
+        while (size > 0)
+        {
+            if (m_offset == m_block.size()) next_block();
+
+            const std::size_t count = std::min(size, m_block.size() - m_offset);
+            std::memcpy(data, m_block.data() + m_offset, count);
+            m_offset += count;
+            m_position += count;
+            data += count;
+            size -= count;
+        }
+    }
+
+    // Bytes read after decompression
+    std::size_t position() const { return m_position; }
+
+    // Reads the end of the stream after the last object, so the wrapped reader stands right after
+    // the compressed stream. Throws if the stream has more data
+    void finish()
+    {
+        if (m_finished) return;
+
+        if (m_offset != m_block.size() || read_header())
+            throw SerializeBufferError("The compressed stream has bytes after the last object.");
+    }
+
+private:
+    // Reads the header of the next block, false at the end of the stream
+    bool read_header()
+    {
+        std::byte header[COMPRESSED_BLOCK_HEADER_SIZE];
+        m_reader.read(header, sizeof(header));
+        load_block_header(header, m_raw_size, m_stored_size);
+
+        m_finished = m_raw_size == 0;
+        return !m_finished;
+    }
+
+    void next_block()
+    {
+        if (m_finished || !read_header()) throw SerializeBufferError("Unexpected end of the compressed stream.");
+
+        const uint32_t raw_size = m_raw_size;
+        const uint32_t stored_size = m_stored_size & ~STORED_BLOCK_FLAG;
+        const bool stored = (m_stored_size & STORED_BLOCK_FLAG) != 0;
+
+        if (stored && stored_size != raw_size) throw SerializeBufferError("Invalid stored block: wrong size.");
+
+        m_block.resize(raw_size);
+        m_offset = 0;
+        if (stored)
+        {
+            m_reader.read(m_block.data(), raw_size);
+            return;
+        }
+
+        m_compressed.resize(stored_size);
+        m_reader.read(m_compressed.data(), stored_size);
+        lz_decompress_block(m_compressed, m_block);
+    }
+
+    Reader& m_reader;
+    std::size_t m_position = 0;
+    bool m_finished = false;
+    uint32_t m_raw_size = 0;
+    uint32_t m_stored_size = 0;
+
+    std::vector<std::byte> m_block;
+    std::size_t m_offset = 0;
+    std::vector<std::byte> m_compressed;
+};
+
+
+
+// Decompresses a whole compressed stream from memory, the blocks are decompressed on `threads` threads
+inline std::vector<std::byte> decompress_parallel(std::span<const std::byte> compressed, std::size_t threads = default_thread_count())
+{
+    struct Block
+    {
+        std::size_t input;
+        std::size_t stored_size;
+        std::size_t output;
+        std::size_t raw_size;
+        bool stored;
+    };
+
+    // The block headers give the place of every block in the input and in the output
+    std::vector<Block> blocks;
+    std::size_t position = 0;
+    std::size_t total = 0;
+    while (true)
+    {
+        uint32_t raw_size = 0;
+        uint32_t stored_size = 0;
+        if (compressed.size() - position < COMPRESSED_BLOCK_HEADER_SIZE) throw SerializeBufferError("Unexpected end of the compressed stream.");
+        load_block_header(compressed.data() + position, raw_size, stored_size);
+        position += COMPRESSED_BLOCK_HEADER_SIZE;
+
+        if (raw_size == 0) break;
+
+        Block block{position, stored_size & ~STORED_BLOCK_FLAG, total, raw_size, (stored_size & STORED_BLOCK_FLAG) != 0};
+        if (compressed.size() - position < block.stored_size) throw SerializeBufferError("Unexpected end of the compressed stream.");
+        if (block.stored && block.stored_size != block.raw_size) throw SerializeBufferError("Invalid stored block: wrong size.");
+
+        blocks.push_back(block);
+        position += block.stored_size;
+        total += block.raw_size;
+    }
+
+    std::vector<std::byte> result(total);
+    run_parallel(blocks.size(), threads, [&](std::size_t i) {
+        const Block& block = blocks[i];
+        std::span<const std::byte> input = compressed.subspan(block.input, block.stored_size);
+        std::span<std::byte> output(result.data() + block.output, block.raw_size);
+
+        if (block.stored)
+            std::memcpy(output.data(), input.data(), block.raw_size);
+        else
+            lz_decompress_block(input, output);
+    });
+
+    return result;
+}
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <bit>
+#include <type_traits>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define SERIALIZE_BYTE_SWAP_X86
+#include <immintrin.h>
+#endif
+
+/*
+Byte swapping of scalars and of blocks of scalars, used by the encodings with a fixed byte
+order (see LittleEndianEncoding in serialize_encoding.hpp) when it is not the byte order of
+the host.
+
+Blocks are swapped 32 bytes at a time with AVX2 vpshufb, or 16 bytes at a time with SSSE3 pshufb,
+the tail is swapped one value at a time. The instruction set is chosen at run time, so the build
+doesn't need -mavx2. Other platforms use the scalar loop, which compilers vectorize themselves.
+*/
+
+
+// Scalars of these types are stored in the byte order of the encoding
+template <typename T>
+constexpr bool is_byte_order_scalar = (std::is_arithmetic_v<T> || std::is_enum_v<T>)
+    && (sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8);
+
+
+template <std::size_t Size>
+struct unsigned_of_size;
+
+template <> struct unsigned_of_size<2> { using type = uint16_t; };
+template <> struct unsigned_of_size<4> { using type = uint32_t; };
+template <> struct unsigned_of_size<8> { using type = uint64_t; };
+
+
+template <typename T>
+T byte_swap_value(T value)
+{
+    static_assert(is_byte_order_scalar<T>, "Only integral, floating point and enum values of 2, 4 or 8 bytes can be byte swapped");
+
+    using U = typename unsigned_of_size<sizeof(T)>::type;
+    return std::bit_cast<T>(std::byteswap(std::bit_cast<U>(value)));
+}
+
+
+
+#ifdef SERIALIZE_BYTE_SWAP_X86
+
+// pshufb mask that reverses every group of Size bytes in a 16-byte lane
+template <std::size_t Size>
+struct byte_swap_mask;
+
+template <>
+struct byte_swap_mask<2>
+{
+    alignas(16) static constexpr uint8_t bytes[16] = {1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14};
+};
+
+template <>
+struct byte_swap_mask<4>
+{
+    alignas(16) static constexpr uint8_t bytes[16] = {3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12};
+};
+
+template <>
+struct byte_swap_mask<8>
+{
+    alignas(16) static constexpr uint8_t bytes[16] = {7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8};
+};
+
+
+// Both kernels return the number of bytes they swapped (a multiple of their vector width)
+__attribute__((target("avx2")))
+inline std::size_t byte_swap_avx2(const std::byte* src, std::byte* dst, std::size_t size, const uint8_t* mask_bytes)
+{
+    const __m128i lane = _mm_load_si128(reinterpret_cast<const __m128i*>(mask_bytes));
+    const __m256i mask = _mm256_broadcastsi128_si256(lane);
+
+    std::size_t i = 0;
+    for (; i + 32 <= size; i += 32)
+    {
+        const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_shuffle_epi8(block, mask));
+    }
+    return i;
+}
+
+__attribute__((target("ssse3")))
+inline std::size_t byte_swap_ssse3(const std::byte* src, std::byte* dst, std::size_t size, const uint8_t* mask_bytes)
+{
+    const __m128i mask = _mm_load_si128(reinterpret_cast<const __m128i*>(mask_bytes));
+
+    std::size_t i = 0;
+    for (; i + 16 <= size; i += 16)
+    {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_shuffle_epi8(block, mask));
+    }
+    return i;
+}
+
+
+enum class ByteSwapKernel
+{
+    Scalar,
+    SSSE3,
+    AVX2
+};
+
+inline ByteSwapKernel byte_swap_kernel()
+{
+    static const ByteSwapKernel kernel = [] {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) return ByteSwapKernel::AVX2;
+        if (__builtin_cpu_supports("ssse3")) return ByteSwapKernel::SSSE3;
+        return ByteSwapKernel::Scalar;
+    }();
+    return kernel;
+}
+
+#endif
+
+
+
+// Writes the count values of src with the reversed byte order to dst. src and dst may be the same block
+template <typename T>
+void byte_swap_copy(const T* src, T* dst, std::size_t count)
+{
+    std::size_t done = 0;
+
+#ifdef SERIALIZE_BYTE_SWAP_X86
+    const std::byte* src_bytes = reinterpret_cast<const std::byte*>(src);
+    std::byte* dst_bytes = reinterpret_cast<std::byte*>(dst);
+    const uint8_t* mask = byte_swap_mask<sizeof(T)>::bytes;
+
+    switch (byte_swap_kernel())
+    {
+    case ByteSwapKernel::AVX2:
+        done = byte_swap_avx2(src_bytes, dst_bytes, count * sizeof(T), mask) / sizeof(T);
+        break;
+    case ByteSwapKernel::SSSE3:
+        done = byte_swap_ssse3(src_bytes, dst_bytes, count * sizeof(T), mask) / sizeof(T);
+        break;
+    case ByteSwapKernel::Scalar:
+        break;
+    }
+#endif
+
+    for (std::size_t i = done; i < count; ++i)
+        dst[i] = byte_swap_value(src[i]);
+}
+
+template <typename T>
+void byte_swap_block(T* data, std::size_t count)
+{
+    byte_swap_copy(data, data, count);
+}
@@ -0,0 +1,263 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "serialize_buffer.hpp"
+#include "serialize_encoding.hpp"
+
+/*
+Push-based incremental deserialization: the input comes in fragments of any size, and the
+decoder keeps its progress between them instead of waiting for the whole payload.
+
+    std::vector<std::string> vec;
+    IncrementalDeserializer<std::vector<std::string>> decoder(vec);
+    while (decoder.feed(next_fragment()) == DecodeStatus::NeedMore) {}
+
+The format is the format of serialize(). For containers (sequential, associative and
+forward_list) the progress is kept per element of the container: every element is decoded
+and moved into the container as soon as all its bytes have arrived, and only the bytes
+of the unfinished element are kept. So the memory held by the decoder is about one element
+plus one fragment, not the whole payload. Other types (scalars, std::string, ...) are decoded
+once all their bytes have arrived.
+
+A decoding attempt that runs out of bytes remembers how many bytes it needed, and the next
+attempt waits until at least that many bytes are buffered, so small fragments of a large
+element don't decode it again and again.
+
+Bytes fed after the end of the object are kept in leftover(), so objects written one after
+another can be decoded by a chain of decoders. Views (std::string_view, std::span) can't be
+decoded: the buffer they would point into is reused.
+*/
+
+
+enum class DecodeStatus
+{
+    NeedMore,
+    Done
+};
+
+
+// Thrown by FragmentReader when the buffered bytes end in the middle of an object
+class IncompleteInputError : public SerializeBufferError {
+public:
+    explicit IncompleteInputError(std::size_t needed)
+        : SerializeBufferError("Incomplete input: " + std::to_string(needed) + " bytes are needed."), m_needed(needed) {}
+
+    std::size_t needed() const { return m_needed; }
+
+private:
+    std::size_t m_needed;
+};
+
+
+// Reads from the buffered bytes of IncrementalDeserializer, position() counts from the start of the input
+class FragmentReader
+{
+public:
+    FragmentReader(std::span<const std::byte> buffer, std::size_t base_position)
+        : m_buffer(buffer), m_base_position(base_position) {}
+
+    void read(std::byte* data, std::size_t size)
+    {
+        if (size > m_buffer.size() - m_position) throw IncompleteInputError(m_position + size);
+
+        std::memcpy(data, m_buffer.data() + m_position, size);
+        m_position += size;
+    }
+
+    std::size_t position() const { return m_base_position + m_position; }
+    std::size_t consumed() const { return m_position; }
+
+private:
+    std::span<const std::byte> m_buffer;
+    std::size_t m_base_position;
+    std::size_t m_position = 0;
+};
+
+
+
+template <typename C, typename = void>
+struct has_incremental_push_back : std::false_type{};
+
+template <typename C>
+struct has_incremental_push_back<C, std::void_t<decltype(std::declval<C&>().push_back(std::declval<typename C::value_type&&>()))>>
+    : std::true_type{};
+
+
+template <typename C, typename = void>
+struct has_incremental_insert_after : std::false_type{};
+
+template <typename C>
+struct has_incremental_insert_after<C, std::void_t<decltype(std::declval<C&>().insert_after(std::declval<C&>().before_begin(), std::declval<typename C::value_type&&>()))>>
+    : std::true_type{};
+
+
+template <typename C, typename = void>
+struct has_incremental_insert : std::false_type{};
+
+template <typename C>
+struct has_incremental_insert<C, std::void_t<decltype(std::declval<C&>().insert(std::declval<typename C::value_type&&>()))>>
+    : std::true_type{};
+
+
+template <typename C, typename = void>
+struct has_incremental_clear : std::false_type{};
+
+template <typename C>
+struct has_incremental_clear<C, std::void_t<decltype(std::declval<C&>().clear())>>
+    : std::true_type{};
+
+
+// Containers that are decoded element by element (std::string is decoded as a whole)
+template <typename C>
+struct is_incremental_container : std::bool_constant<
+    !std::is_same_v<C, std::string> && has_incremental_clear<C>::value
+    && (has_incremental_push_back<C>::value || has_incremental_insert_after<C>::value || has_incremental_insert<C>::value)>{};
+
+
+// The position after the last element of a forward_list, unused for other types
+template <typename C, typename = void>
+struct incremental_tail
+{
+    using type = int;
+};
+
+template <typename C>
+struct incremental_tail<C, std::enable_if_t<is_incremental_container<C>::value && has_incremental_insert_after<C>::value>>
+{
+    using type = decltype(std::declval<C&>().before_begin());
+};
+
+
+template <typename T>
+struct is_span_view : std::false_type{};
+
+template <typename T>
+struct is_span_view<std::span<const T>> : std::true_type{};
+
+
+
+template <typename T, typename Encoding = FixedEncoding>
+class IncrementalDeserializer
+{
+public:
+    static_assert(!Encoding::aligned_blocks, "Incremental deserialization does not support the aligned encoding");
+    static_assert(!std::is_same_v<T, std::string_view> && !is_span_view<T>::value,
+                  "Views can't be deserialized incrementally: the buffer they point into is reused");
+
+    explicit IncrementalDeserializer(T& obj) : m_obj(obj) {}
+
+    // Adds the next fragment of the input and decodes as much of it as possible
+    DecodeStatus feed(std::span<const std::byte> fragment)
+    {
+        // Drop the decoded bytes once they are the larger part of the buffer, so moving the rest stays cheap
+        if (m_start > 0 && m_start >= m_buffer.size() - m_start)
+        {
+            m_buffer.erase(m_buffer.begin(), m_buffer.begin() + static_cast<std::ptrdiff_t>(m_start));
+            m_start = 0;
+        }
+        m_buffer.insert(m_buffer.end(), fragment.begin(), fragment.end());
+
+        while (m_stage != Stage::Done)
+        {
+            if (buffered() < m_needed) return DecodeStatus::NeedMore;
+
+            FragmentReader inner(std::span<const std::byte>(m_buffer).subspan(m_start), m_consumed);
+            EncodedReader<Encoding, FragmentReader> r(inner);
+            try
+            {
+                step(r);
+            }
+            catch (const IncompleteInputError& e)
+            {
+                m_needed = e.needed();
+                return DecodeStatus::NeedMore;
+            }
+
+            m_start += inner.consumed();
+            m_consumed += inner.consumed();
+            m_needed = 0;
+        }
+
+        return DecodeStatus::Done;
+    }
+
+    bool done() const { return m_stage == Stage::Done; }
+
+    // Bytes of the input that are held until the rest of an element arrives
+    std::size_t buffered() const { return m_buffer.size() - m_start; }
+
+    // Bytes of the input that are already decoded
+    std::size_t consumed() const { return m_consumed; }
+
+    // Bytes fed after the end of the object
+    std::span<const std::byte> leftover() const
+    {
+        if (!done()) return {};
+        return std::span<const std::byte>(m_buffer).subspan(m_start);
+    }
+
+private:
+    enum class Stage
+    {
+        Length,
+        Elements,
+        Done
+    };
+
+    template <typename Reader>
+    void step(Reader& r)
+    {
+        if constexpr (is_incremental_container<T>::value)
+        {
+            if (m_stage == Stage::Length)
+            {
+                m_len = read_length(r);
+                m_obj.clear();
+                if constexpr (has_incremental_insert_after<T>::value)
+                    m_tail = m_obj.before_begin();
+
+                m_stage = m_len > 0 ? Stage::Elements : Stage::Done;
+                return;
+            }
+
+            // Elements already in the container are kept, the unfinished one is decoded again
+            typename T::value_type obj{};
+            deserialize(obj, r);
+
+            if constexpr (has_incremental_push_back<T>::value)
+                m_obj.push_back(std::move(obj));
+            else if constexpr (has_incremental_insert_after<T>::value)
+                m_tail = m_obj.insert_after(m_tail, std::move(obj));
+            else
+                m_obj.insert(std::move(obj));
+
+            if (++m_decoded == m_len) m_stage = Stage::Done;
+        }
+        else
+        {
+            deserialize(m_obj, r);
+            m_stage = Stage::Done;
+        }
+    }
+
+    T& m_obj;
+    Stage m_stage = Stage::Length;
+
+    std::vector<std::byte> m_buffer;
+    std::size_t m_start = 0;
+    std::size_t m_consumed = 0;
+    std::size_t m_needed = 0;
+
+    uint32_t m_len = 0;
+    uint32_t m_decoded = 0;
+    typename incremental_tail<T>::type m_tail{};
+};
@@ -0,0 +1,316 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <span>
+#include <string>
+#include <stdexcept>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <bit>
+
+#include "serialize_buffer.hpp"
+#include "serialize_encoding.hpp"
+
+/*
+Indexed archive: a self-describing format for one container with an index, so a reader can
+get the element N of a sequence or the value of the key K of a sorted map without decoding
+the whole archive.
+
+    std::vector<std::byte> buffer;
+    VectorWriter w(buffer);
+    serialize_indexed(big_vector, w);
+
+    IndexedArchiveReader archive(buffer);
+    std::string element;
+    archive.read(900000, element);
+
+Format (the numbers of the header, the index and the footer are little-endian on every host,
+elements are written with serialize() and the encoding of the writer):
+    header:   char[4] magic "SRIX", uint16_t version, uint8_t kind (sequence / map), uint8_t flags (varint, big-endian body)
+    body:     the elements one after another (for maps: key, then value)
+    index:    uint64_t offset of every element from the beginning of the archive
+    footer:   uint64_t offset of the index, uint64_t number of elements, char[4] magic "SRIX"
+
+The keys of a map are written in the order of the map, so the reader finds a key with a
+binary search over the index: O(log n) keys are decoded. The encoding and the byte order of the
+body are stored in the header, so the reader doesn't need to know them. An archive written with
+FixedEncoding, LittleEndianEncoding or BigEndianEncoding can be read on any host, a varint archive
+only on a host with the same byte order (its floating point values are native). Only the outermost
+container is indexed, its elements are decoded as a whole. The aligned encoding is not supported.
+*/
+
+
+class IndexedArchiveError : public std::runtime_error {
+public:
+    explicit IndexedArchiveError(const std::string& message)
+        : std::runtime_error(message) {}
+};
+
+
+enum class IndexedArchiveKind : uint8_t
+{
+    Sequence = 1,
+    Map = 2
+};
+
+
+constexpr char INDEXED_ARCHIVE_MAGIC[4] = {'S', 'R', 'I', 'X'};
+constexpr uint16_t INDEXED_ARCHIVE_VERSION = 1;
+constexpr uint8_t INDEXED_ARCHIVE_VARINT_FLAG = 1;
+constexpr uint8_t INDEXED_ARCHIVE_BIG_ENDIAN_FLAG = 2;
+
+constexpr std::size_t INDEXED_ARCHIVE_HEADER_SIZE = sizeof(INDEXED_ARCHIVE_MAGIC) + sizeof(uint16_t) + 2 * sizeof(uint8_t);
+constexpr std::size_t INDEXED_ARCHIVE_FOOTER_SIZE = 2 * sizeof(uint64_t) + sizeof(INDEXED_ARCHIVE_MAGIC);
+
+
+
+// Sorted maps are indexed by key, everything else is a sequence
+template <typename C, typename = void>
+struct is_indexed_map : std::false_type{};
+
+template <typename C>
+struct is_indexed_map<C, std::void_t<typename C::key_type, typename C::mapped_type, typename C::key_compare>> : std::true_type{};
+
+
+// Forwards bytes to another writer and counts them, so writers without position() can be used
+template <typename Writer>
+class CountingWriter
+{
+public:
+    using encoding = encoding_of_t<Writer>;
+
+    explicit CountingWriter(Writer& writer) : m_writer(writer) {}
+
+    void write(const std::byte* data, std::size_t size)
+    {
+        m_writer.write(data, size);
+        m_count += size;
+    }
+
+    std::size_t position() const { return m_count; }
+
+private:
+    Writer& m_writer;
+    std::size_t m_count = 0;
+};
+
+
+// The numbers of the header, the index and the footer
+template <typename T, typename Writer>
+void write_archive_number(const T& value, Writer& w)
+{
+    EncodedWriter<LittleEndianEncoding, Writer> little_endian(w);
+    write_value(value, little_endian);
+}
+
+template <typename T>
+T read_archive_number(const std::byte* data)
+{
+    T value{};
+    std::memcpy(&value, data, sizeof(T));
+    if constexpr (needs_byte_swap<T, LittleEndianEncoding>)
+        value = byte_swap_value(value);
+    return value;
+}
+
+
+
+template <typename ContainerType, typename Writer>
+void serialize_indexed(const ContainerType& c, Writer& w)
+{
+    using Encoding = encoding_of_t<Writer>;
+    static_assert(!Encoding::aligned_blocks, "The indexed archive does not support the aligned encoding");
+    static_assert(!Encoding::varint || Encoding::byte_order == std::endian::native, "Varint archives are written in the byte order of the host");
+
+    constexpr bool is_map = is_indexed_map<ContainerType>::value;
+    CountingWriter<Writer> counting(w);
+
+    // Header
+    counting.write(reinterpret_cast<const std::byte*>(INDEXED_ARCHIVE_MAGIC), sizeof(INDEXED_ARCHIVE_MAGIC));
+    write_archive_number(INDEXED_ARCHIVE_VERSION, counting);
+    write_archive_number(static_cast<uint8_t>(is_map ? IndexedArchiveKind::Map : IndexedArchiveKind::Sequence), counting);
+    write_archive_number(static_cast<uint8_t>((Encoding::varint ? INDEXED_ARCHIVE_VARINT_FLAG : 0)
+                                              | (Encoding::byte_order == std::endian::big ? INDEXED_ARCHIVE_BIG_ENDIAN_FLAG : 0)), counting);
+
+    // Body
+    std::vector<uint64_t> offsets;
+    offsets.reserve(c.size());
+    for (const auto& obj : c)
+    {
+        offsets.push_back(counting.position());
+        if constexpr (is_map)
+        {
+            serialize(obj.first, counting);
+            serialize(obj.second, counting);
+        }
+        else
+            serialize(obj, counting);
+    }
+
+    // Index and footer
+    const uint64_t index_offset = counting.position();
+    EncodedWriter<LittleEndianEncoding, CountingWriter<Writer>> index_writer(counting);
+    write_raw_block(offsets.data(), offsets.size(), index_writer);
+    write_archive_number(index_offset, counting);
+    write_archive_number(static_cast<uint64_t>(offsets.size()), counting);
+    counting.write(reinterpret_cast<const std::byte*>(INDEXED_ARCHIVE_MAGIC), sizeof(INDEXED_ARCHIVE_MAGIC));
+}
+
+
+
+// Reads an indexed archive from memory (a buffer, MappedFileReader::bytes(), ...). The memory must outlive the reader
+class IndexedArchiveReader
+{
+public:
+    explicit IndexedArchiveReader(std::span<const std::byte> archive) : m_archive(archive)
+    {
+        if (archive.size() < INDEXED_ARCHIVE_HEADER_SIZE + INDEXED_ARCHIVE_FOOTER_SIZE)
+            throw IndexedArchiveError("Invalid indexed archive: it is too short.");
+
+        const std::byte* data = archive.data();
+        const std::byte* footer = data + archive.size() - INDEXED_ARCHIVE_FOOTER_SIZE;
+        if (std::memcmp(data, INDEXED_ARCHIVE_MAGIC, sizeof(INDEXED_ARCHIVE_MAGIC)) != 0
+            || std::memcmp(footer + 2 * sizeof(uint64_t), INDEXED_ARCHIVE_MAGIC, sizeof(INDEXED_ARCHIVE_MAGIC)) != 0)
+            throw IndexedArchiveError("Invalid indexed archive: wrong magic.");
+
+        const uint16_t version = read_archive_number<uint16_t>(data + sizeof(INDEXED_ARCHIVE_MAGIC));
+        if (version != INDEXED_ARCHIVE_VERSION)
+            throw IndexedArchiveError("Unsupported indexed archive version " + std::to_string(version) + ".");
+
+        const uint8_t kind = read_archive_number<uint8_t>(data + sizeof(INDEXED_ARCHIVE_MAGIC) + sizeof(version));
+        if (kind != static_cast<uint8_t>(IndexedArchiveKind::Sequence) && kind != static_cast<uint8_t>(IndexedArchiveKind::Map))
+            throw IndexedArchiveError("Invalid indexed archive: unknown kind " + std::to_string(kind) + ".");
+        m_kind = static_cast<IndexedArchiveKind>(kind);
+
+        const uint8_t flags = read_archive_number<uint8_t>(data + sizeof(INDEXED_ARCHIVE_MAGIC) + sizeof(version) + sizeof(kind));
+        m_varint = (flags & INDEXED_ARCHIVE_VARINT_FLAG) != 0;
+        m_big_endian = (flags & INDEXED_ARCHIVE_BIG_ENDIAN_FLAG) != 0;
+        if (m_varint && m_big_endian != (std::endian::native == std::endian::big))
+            throw IndexedArchiveError("The varint archive was written on a host with another byte order.");
+
+        const uint64_t index_offset = read_archive_number<uint64_t>(footer);
+        const uint64_t count = read_archive_number<uint64_t>(footer + sizeof(index_offset));
+
+        // The index must lie exactly between the body and the footer
+        const std::size_t footer_offset = archive.size() - INDEXED_ARCHIVE_FOOTER_SIZE;
+        if (index_offset < INDEXED_ARCHIVE_HEADER_SIZE || index_offset > footer_offset
+            || (footer_offset - index_offset) / sizeof(uint64_t) != count || (footer_offset - index_offset) % sizeof(uint64_t) != 0)
+            throw IndexedArchiveError("Invalid indexed archive: the index doesn't match the footer.");
+
+        m_index = data + index_offset;
+        m_index_offset = static_cast<std::size_t>(index_offset);
+        m_size = static_cast<std::size_t>(count);
+    }
+
+    std::size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    IndexedArchiveKind kind() const { return m_kind; }
+    bool varint() const { return m_varint; }
+    bool big_endian() const { return m_big_endian; }
+
+    // Decodes the element `index` of a sequence
+    template <typename T>
+    void read(std::size_t index, T& element) const
+    {
+        check_kind(IndexedArchiveKind::Sequence);
+        with_element_reader(index, [&](auto& r) { deserialize(element, r); });
+    }
+
+    // Decodes the key and the value of the element `index` of a map
+    template <typename K, typename V>
+    void read(std::size_t index, K& key, V& value) const
+    {
+        check_kind(IndexedArchiveKind::Map);
+        with_element_reader(index, [&](auto& r) {
+            deserialize(key, r);
+            deserialize(value, r);
+        });
+    }
+
+    // Binary search for the key in a map archive, decodes its value if it is found. Key is the type
+    // of the stored keys (find<long long>(42, value)), the argument is converted to it
+    template <typename Key = std::string, typename V, typename Compare = std::less<>>
+    bool find(const std::type_identity_t<Key>& key, V& value, Compare compare = Compare{}) const
+    {
+        check_kind(IndexedArchiveKind::Map);
+
+        std::size_t first = 0;
+        std::size_t last = m_size;
+        Key current{};
+        while (first < last)
+        {
+            const std::size_t middle = first + (last - first) / 2;
+            with_element_reader(middle, [&](auto& r) { deserialize(current, r); });
+
+            if (compare(current, key))
+                first = middle + 1;
+            else
+                last = middle;
+        }
+
+        if (first == m_size) return false;
+        bool found = false;
+        with_element_reader(first, [&](auto& r) {
+            deserialize(current, r);
+            if (compare(key, current)) return;
+
+            deserialize(value, r);
+            found = true;
+        });
+        return found;
+    }
+
+private:
+    void check_kind(IndexedArchiveKind kind) const
+    {
+        if (m_kind != kind)
+            throw IndexedArchiveError(kind == IndexedArchiveKind::Map ? "The archive is not a map." : "The archive is not a sequence.");
+    }
+
+    std::size_t element_offset(std::size_t index) const
+    {
+        if (index >= m_size)
+            throw IndexedArchiveError("Index " + std::to_string(index) + " is out of range, the archive has " + std::to_string(m_size) + " elements.");
+
+        const uint64_t offset = read_archive_number<uint64_t>(m_index + index * sizeof(uint64_t));
+        if (offset < INDEXED_ARCHIVE_HEADER_SIZE || offset > m_index_offset)
+            throw IndexedArchiveError("Invalid indexed archive: element " + std::to_string(index) + " is outside of the body.");
+        return static_cast<std::size_t>(offset);
+    }
+
+    // Calls f with a reader that starts at the element and ends at the index, decoding with the stored encoding
+    template <typename F>
+    void with_element_reader(std::size_t index, F&& f) const
+    {
+        const std::size_t offset = element_offset(index);
+        SpanReader inner(m_archive.subspan(offset, m_index_offset - offset));
+
+        if (m_varint)
+        {
+            EncodedReader<VarintEncoding, SpanReader> r(inner);
+            f(r);
+        }
+        else if (m_big_endian)
+        {
+            EncodedReader<BigEndianEncoding, SpanReader> r(inner);
+            f(r);
+        }
+        else
+        {
+            EncodedReader<LittleEndianEncoding, SpanReader> r(inner);
+            f(r);
+        }
+    }
+
+    std::span<const std::byte> m_archive;
+    const std::byte* m_index = nullptr;
+    std::size_t m_index_offset = 0;
+    std::size_t m_size = 0;
+    IndexedArchiveKind m_kind = IndexedArchiveKind::Sequence;
+    bool m_varint = false;
+    bool m_big_endian = false;
+};
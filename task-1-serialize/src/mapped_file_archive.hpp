@@ -0,0 +1,194 @@
+#pragma once
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <cstddef>
+#include <cstring>
+#include <cerrno>
+#include <span>
+#include <string>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "serialize_buffer.hpp"
+
+/*
+Memory-mapped file archive: a writer and a reader that work with a file through mmap.
+
+MappedFileWriter maps the output file and grows it in large chunks with ftruncate, so
+serialize() only copies bytes into memory. close() (or the destructor) cuts the file
+to the number of bytes written.
+
+MappedFileReader maps the input file read-only, so deserialize() costs page faults instead
+of read() syscalls and stream copies. It has view(), so strings and blocks can be
+deserialized into std::string_view / std::span<const T> that point into the mapping.
+Views are valid while the reader is alive.
+
+    {
+        MappedFileWriter w("data.bin");
+        serialize(big_map, w);
+    }
+    MappedFileReader r("data.bin");
+    deserialize(big_map, r);
+
+Only POSIX systems are supported.
+*/
+
+
+class MappedFileError : public std::runtime_error {
+public:
+    MappedFileError(const std::string& message, int error)
+        : std::runtime_error(message + " (" + std::strerror(error) + ")") {}
+};
+
+
+
+class MappedFileWriter
+{
+public:
+    static constexpr std::size_t DEFAULT_CHUNK_SIZE = 64 * 1024 * 1024;
+
+    explicit MappedFileWriter(const std::string& filename, std::size_t chunk_size = DEFAULT_CHUNK_SIZE)
+        : m_chunk_size(chunk_size > 0 ? chunk_size : DEFAULT_CHUNK_SIZE)
+    {
+        m_fd = ::open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (m_fd < 0) throw MappedFileError("Cannot open the file " + filename, errno);
+    }
+
+    MappedFileWriter(const MappedFileWriter&) = delete;
+    MappedFileWriter& operator=(const MappedFileWriter&) = delete;
+
+    ~MappedFileWriter()
+    {
+        try
+        {
+            close();
+        }
+        catch (...) {}
+    }
+
+    void write(const std::byte* data, std::size_t size)
+    {
+        if (m_fd < 0) throw SerializeBufferError("Cannot write to a closed MappedFileWriter.");
+        if (size == 0) return;
+        if (size > m_capacity || m_position > m_capacity - size) grow(m_position + size);
+
+        std::memcpy(m_data + m_position, data, size);
+        m_position += size;
+    }
+
+    std::size_t position() const { return m_position; }
+
+    // Unmaps the file and cuts it to the written size
+    void close()
+    {
+        if (m_fd < 0) return;
+
+        unmap();
+        const int fd = m_fd;
+        m_fd = -1;
+
+        const int error = ::ftruncate(fd, static_cast<off_t>(m_position)) == 0 ? 0 : errno;
+        ::close(fd);
+        if (error != 0) throw MappedFileError("Cannot set the size of the file", error);
+    }
+
+private:
+    void grow(std::size_t required)
+    {
+        if (m_fd < 0) throw SerializeBufferError("Cannot write to a closed MappedFileWriter.");
+
+        // Grow at least by one chunk and at least twice, so the number of remaps is logarithmic
+        std::size_t new_capacity = m_capacity + m_chunk_size;
+        if (new_capacity < 2 * m_capacity) new_capacity = 2 * m_capacity;
+        if (new_capacity < required) new_capacity = required;
+
+        unmap();
+        if (::ftruncate(m_fd, static_cast<off_t>(new_capacity)) != 0)
+            throw MappedFileError("Cannot grow the file to " + std::to_string(new_capacity) + " bytes", errno);
+
+        void* data = ::mmap(nullptr, new_capacity, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+        if (data == MAP_FAILED) throw MappedFileError("Cannot map the file", errno);
+
+        m_data = static_cast<std::byte*>(data);
+        m_capacity = new_capacity;
+    }
+
+    void unmap()
+    {
+        if (m_data != nullptr) ::munmap(m_data, m_capacity);
+        m_data = nullptr;
+        m_capacity = 0;
+    }
+
+    int m_fd = -1;
+    std::byte* m_data = nullptr;
+    std::size_t m_capacity = 0;
+    std::size_t m_position = 0;
+    std::size_t m_chunk_size;
+};
+
+
+
+class MappedFileReader
+{
+public:
+    explicit MappedFileReader(const std::string& filename)
+    {
+        const int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) throw MappedFileError("Cannot open the file " + filename, errno);
+
+        struct stat info{};
+        if (::fstat(fd, &info) != 0)
+        {
+            const int error = errno;
+            ::close(fd);
+            throw MappedFileError("Cannot get the size of the file " + filename, error);
+        }
+        m_size = static_cast<std::size_t>(info.st_size);
+
+        // An empty file can't be mapped, the reader just has no bytes
+        if (m_size > 0)
+        {
+            void* data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data == MAP_FAILED)
+            {
+                const int error = errno;
+                ::close(fd);
+                throw MappedFileError("Cannot map the file " + filename, error);
+            }
+            m_data = static_cast<const std::byte*>(data);
+            ::madvise(const_cast<std::byte*>(m_data), m_size, MADV_SEQUENTIAL);
+        }
+        ::close(fd);
+
+        m_reader = SpanReader(std::span<const std::byte>(m_data, m_size));
+    }
+
+    MappedFileReader(const MappedFileReader&) = delete;
+    MappedFileReader& operator=(const MappedFileReader&) = delete;
+
+    ~MappedFileReader()
+    {
+        if (m_data != nullptr) ::munmap(const_cast<std::byte*>(m_data), m_size);
+    }
+
+    void read(std::byte* data, std::size_t size) { m_reader.read(data, size); }
+    const std::byte* view(std::size_t size) { return m_reader.view(size); }
+
+    std::size_t position() const { return m_reader.position(); }
+    std::size_t remaining() const { return m_reader.remaining(); }
+
+    std::span<const std::byte> bytes() const { return std::span<const std::byte>(m_data, m_size); }
+
+private:
+    const std::byte* m_data = nullptr;
+    std::size_t m_size = 0;
+    SpanReader m_reader{std::span<const std::byte>()};
+};
+
+#endif
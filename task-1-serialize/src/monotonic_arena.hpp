@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <algorithm>
+
+/*
+MonotonicArena is a std::pmr::memory_resource for bursts of short-lived objects, for example
+thousands of small vectors made by one deserialize() call:
+
+    MonotonicArena arena;
+    PmrMyVector<PmrMyVector<int>> vectors(&arena);
+    deserialize(vectors, r);
+    ...
+    arena.release();    // or let the arena go out of scope
+
+Allocation moves a pointer inside the current chunk, deallocation does nothing, the memory
+of all objects is freed at once by release() or by the destructor. The chunks come from the
+upstream resource, every next chunk is twice as large as the previous one. The objects must
+be destroyed (or never used again) before the memory is released. The arena is not thread-safe.
+*/
+
+
+class MonotonicArena : public std::pmr::memory_resource
+{
+public:
+    static constexpr std::size_t DEFAULT_CHUNK_SIZE = 64 * 1024;
+
+    explicit MonotonicArena(std::size_t first_chunk_size = DEFAULT_CHUNK_SIZE,
+                            std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : m_upstream(upstream), m_first_chunk_size(std::max(first_chunk_size, sizeof(Chunk) * 2)), m_next_chunk_size(m_first_chunk_size)
+    {}
+
+    MonotonicArena(const MonotonicArena&) = delete;
+    MonotonicArena& operator=(const MonotonicArena&) = delete;
+
+    ~MonotonicArena() override
+    {
+        release();
+    }
+
+    // Frees all chunks, the next allocation starts from a chunk of the first size again
+    void release()
+    {
+        while (m_chunks != nullptr)
+        {
+            Chunk* next = m_chunks->next;
+            m_upstream->deallocate(m_chunks, m_chunks->size, alignof(Chunk));
+            m_chunks = next;
+        }
+        m_current = nullptr;
+        m_left = 0;
+        m_next_chunk_size = m_first_chunk_size;
+        m_allocated_bytes = 0;
+    }
+
+    // Bytes handed out since the last release(), without the alignment gaps
+    std::size_t allocated_bytes() const { return m_allocated_bytes; }
+
+    std::size_t chunk_count() const
+    {
+        std::size_t count = 0;
+        for (const Chunk* chunk = m_chunks; chunk != nullptr; chunk = chunk->next)
+            ++count;
+        return count;
+    }
+
+private:
+    // Header at the start of every chunk
+    struct Chunk
+    {
+        Chunk* next;
+        std::size_t size;
+    };
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        std::size_t padding = padding_for(m_current, alignment);
+        if (m_current == nullptr || padding + bytes > m_left)
+        {
+            add_chunk(bytes + alignment);
+            padding = padding_for(m_current, alignment);
+        }
+
+        std::byte* result = m_current + padding;
+        m_current = result + bytes;
+        m_left -= padding + bytes;
+        m_allocated_bytes += bytes;
+        return result;
+    }
+
+    void do_deallocate(void*, std::size_t, std::size_t) override {}
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+
+    static std::size_t padding_for(const std::byte* ptr, std::size_t alignment)
+    {
+        const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(ptr);
+        return (alignment - address % alignment) % alignment;
+    }
+
+    void add_chunk(std::size_t min_bytes)
+    {
+        const std::size_t size = std::max(m_next_chunk_size, min_bytes + sizeof(Chunk));
+        Chunk* chunk = static_cast<Chunk*>(m_upstream->allocate(size, alignof(Chunk)));
+        chunk->next = m_chunks;
+        chunk->size = size;
+        m_chunks = chunk;
+
+        m_current = reinterpret_cast<std::byte*>(chunk + 1);
+        m_left = size - sizeof(Chunk);
+        m_next_chunk_size = size * 2;
+    }
+
+    std::pmr::memory_resource* m_upstream;
+    std::size_t m_first_chunk_size;
+    std::size_t m_next_chunk_size;
+
+    Chunk* m_chunks = nullptr;
+    std::byte* m_current = nullptr;
+    std::size_t m_left = 0;
+    std::size_t m_allocated_bytes = 0;
+};
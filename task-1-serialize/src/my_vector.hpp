@@ -2,60 +2,173 @@
 
 #include <algorithm>
 #include <iostream>
+#include <cstddef>
 #include <cstdlib>
 #include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
 #include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "simd_search.hpp"
 
 /*
 MyVector - is my custom data structure. I create it for tests.
+
+It has the interface of a sequence container: emplace_back / push_back / pop_back,
+emplace / insert / erase at any position, resize, reserve and shrink_to_fit. The buffer
+grows at least twice when it is full, so adding elements at the end is amortized O(1).
+Every growth is done by reallocate(): the new elements are constructed in the new buffer
+first, then the old ones are moved there, so insert() of a forward range allocates once
+and the arguments may refer to the elements of the vector itself. If a constructor throws
+while the buffer grows, the vector stays as it was.
+
+The memory comes from the allocator Alloc (std::allocator<T> by default) and the elements
+are constructed through it, like in the standard containers. PmrMyVector<T> takes a
+std::pmr::memory_resource, for example a MonotonicArena (monotonic_arena.hpp), and passes it
+to the nested pmr containers.
+
+Values that compare as their bytes (integers, enums, pointers) are compared with one memcmp
+in operator==, and find / count / contains search them with AVX2 (simd_search.hpp).
+Other types use std::equal / std::find / std::count.
+
+SmallVector<T, N> is MyVector with InlineCapacity = N: the first N elements live inside the
+object and the allocator is used only when the vector grows beyond them. A vector that is
+stored inline can't give its buffer away, so moving or swapping it moves the elements.
 */
 
 
+// Uninitialized memory for InlineCapacity objects inside MyVector, nothing when it is 0
+template <typename T, std::size_t InlineCapacity>
+struct MyVectorInlineStorage
+{
+    T* data() { return reinterpret_cast<T*>(m_bytes); }
+    const T* data() const { return reinterpret_cast<const T*>(m_bytes); }
+
+    alignas(T) std::byte m_bytes[sizeof(T) * InlineCapacity];
+};
+
 template <typename T>
+struct MyVectorInlineStorage<T, 0>
+{
+    T* data() { return nullptr; }
+    const T* data() const { return nullptr; }
+};
+
+
+template <typename T, typename Alloc = std::allocator<T>, std::size_t InlineCapacity = 0>
 class MyVector
 {
+    using alloc_traits = std::allocator_traits<Alloc>;
+
 public:
 
     using value_type = T;
+    using allocator_type = Alloc;
     using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
     using reference = T&;
     using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
     using iterator = T*;
     using const_iterator = const T*;
 
+    static_assert(std::is_same_v<typename alloc_traits::value_type, T>, "The allocator must allocate objects of T");
+    static_assert(std::is_same_v<typename alloc_traits::pointer, T*>, "Only allocators with raw pointers are supported");
+
     MyVector()
     {
         set_default();
     }
 
-    MyVector(const MyVector& other)
+    explicit MyVector(const Alloc& alloc) : m_alloc(alloc) {}
+
+    explicit MyVector(size_type count, const Alloc& alloc = Alloc()) : m_alloc(alloc)
+    {
+        resize(count);
+    }
+
+    MyVector(size_type count, const T& value, const Alloc& alloc = Alloc()) : m_alloc(alloc)
+    {
+        resize(count, value);
+    }
+
+    template <typename InputIt, typename = std::enable_if_t<std::is_base_of_v<std::input_iterator_tag, typename std::iterator_traits<InputIt>::iterator_category>>>
+    MyVector(InputIt first, InputIt last, const Alloc& alloc = Alloc()) : m_alloc(alloc)
+    {
+        insert(end(), first, last);
+    }
+
+    MyVector(std::initializer_list<T> list, const Alloc& alloc = Alloc()) : m_alloc(alloc)
     {
-        if (this == &other) return;
+        insert(end(), list.begin(), list.end());
+    }
 
+    MyVector(const MyVector& other) : m_alloc(alloc_traits::select_on_container_copy_construction(other.m_alloc))
+    {
         clone(other);
     }
 
-    MyVector(MyVector&& other)
+    MyVector(const MyVector& other, const Alloc& alloc) : m_alloc(alloc)
     {
-        if (this == &other) return;
+        clone(other);
+    }
 
-        swap(other);
+    MyVector(MyVector&& other) noexcept(InlineCapacity == 0 || std::is_nothrow_move_constructible_v<T>) : m_alloc(std::move(other.m_alloc))
+    {
+        steal(other);
+    }
+
+    // With another allocator the buffer can't be taken, the elements are moved one by one
+    MyVector(MyVector&& other, const Alloc& alloc) : m_alloc(alloc)
+    {
+        if (m_alloc == other.m_alloc)
+            steal(other);
+        else
+            move_elements(other);
     }
 
     MyVector& operator=(const MyVector& other)
     {
         if (this == &other) return *this;
 
+        if constexpr (alloc_traits::propagate_on_container_copy_assignment::value)
+        {
+            // The old buffer goes back to the old allocator
+            release();
+            m_alloc = other.m_alloc;
+        }
         clone(other);
 
         return *this;
     }
 
-    MyVector& operator=(MyVector&& other)
+    MyVector& operator=(MyVector&& other) noexcept((alloc_traits::propagate_on_container_move_assignment::value || alloc_traits::is_always_equal::value)
+                                                   && (InlineCapacity == 0 || std::is_nothrow_move_constructible_v<T>))
     {
         if (this == &other) return *this;
 
-        swap(other);
+        if constexpr (alloc_traits::propagate_on_container_move_assignment::value)
+        {
+            release();
+            m_alloc = std::move(other.m_alloc);
+            steal(other);
+        }
+        else
+        {
+            if (m_alloc == other.m_alloc)
+            {
+                release();
+                steal(other);
+            }
+            else
+                move_elements(other);
+        }
 
         return *this;
     }
@@ -65,6 +178,8 @@ public:
         release();
     }
 
+    allocator_type get_allocator() const { return m_alloc; }
+
     iterator begin() { return m_data; }
     iterator end() { return m_data + m_size; }
     const_iterator begin() const { return m_data; }
@@ -74,23 +189,217 @@ public:
 
     size_type size() const { return m_size; }
     size_type capacity() const { return m_capacity; }
+    bool empty() const { return m_size == 0; }
 
-    void push_back(const T& value)
+    T* data() { return m_data; }
+    const T* data() const { return m_data; }
+
+    T& front() { return m_data[0]; }
+    const T& front() const { return m_data[0]; }
+    T& back() { return m_data[m_size - 1]; }
+    const T& back() const { return m_data[m_size - 1]; }
+
+    T& at(size_type index)
+    {
+        if (index >= m_size) throw std::out_of_range("MyVector::at: index is out of range");
+        return m_data[index];
+    }
+
+    const T& at(size_type index) const
     {
-        if (m_capacity == 0) reserve(1);
-        else if (m_size == m_capacity) reserve(m_capacity * 2);
+        if (index >= m_size) throw std::out_of_range("MyVector::at: index is out of range");
+        return m_data[index];
+    }
+
+    template <typename... Args>
+    T& emplace_back(Args&&... args)
+    {
+        if (m_size == m_capacity)
+        {
+            // The arguments may refer to the elements, so the new element is constructed before they move
+            reallocate(grown_capacity(m_size + 1), m_size, 1, [&](T* place) { construct(place, std::forward<Args>(args)...); });
+        }
+        else
+        {
+            construct(m_data + m_size, std::forward<Args>(args)...);
+            ++m_size;
+        }
+        return back();
+    }
 
-        new (m_data + m_size) T(value); // Прочесть что это такое
-        ++m_size;
+    void push_back(const T& value)
+    {
+        emplace_back(value);
     }
 
     void push_back(T&& value)
     {
-        if (m_capacity == 0) reserve(1);
-        else if (m_size == m_capacity) reserve(m_capacity * 2);
+        emplace_back(std::move(value));
+    }
+
+    void pop_back()
+    {
+        --m_size;
+        destroy(m_data + m_size, m_data + m_size + 1);
+    }
+
+    template <typename... Args>
+    iterator emplace(const_iterator pos, Args&&... args)
+    {
+        const size_type index = static_cast<size_type>(pos - m_data);
+        if (index == m_size)
+        {
+            emplace_back(std::forward<Args>(args)...);
+            return m_data + index;
+        }
+
+        if (m_size == m_capacity)
+        {
+            reallocate(grown_capacity(m_size + 1), index, 1, [&](T* place) { construct(place, std::forward<Args>(args)...); });
+            return m_data + index;
+        }
+
+        // The arguments may refer to the elements that are about to shift, so the new element
+        // is made aside first. Like the elements, it is constructed through the allocator
+        alignas(T) std::byte storage[sizeof(T)];
+        construct(reinterpret_cast<T*>(storage), std::forward<Args>(args)...);
+        T* const value = std::launder(reinterpret_cast<T*>(storage));
+        try
+        {
+            construct(m_data + m_size, std::move(m_data[m_size - 1]));
+            ++m_size;
+            std::move_backward(m_data + index, m_data + m_size - 2, m_data + m_size - 1);
+            m_data[index] = std::move(*value);
+        }
+        catch (...)
+        {
+            destroy(value, value + 1);
+            throw;
+        }
+        destroy(value, value + 1);
+        return m_data + index;
+    }
+
+    iterator insert(const_iterator pos, const T& value)
+    {
+        return emplace(pos, value);
+    }
+
+    iterator insert(const_iterator pos, T&& value)
+    {
+        return emplace(pos, std::move(value));
+    }
+
+    iterator insert(const_iterator pos, size_type count, const T& value)
+    {
+        const size_type index = static_cast<size_type>(pos - m_data);
+        if (count == 0) return m_data + index;
+
+        if (m_size + count > m_capacity)
+        {
+            reallocate(grown_capacity(m_size + count), index, count, [&](T* place) {
+                construct_each(place, count, [&](T* p) { construct(p, value); });
+            });
+            return m_data + index;
+        }
+
+        const T copy(value);
+        insert_in_place(index, count, [&](T* place, size_type n) { construct_each(place, n, [&](T* p) { construct(p, copy); }); },
+                                      [&](T* place, size_type n) { std::fill_n(place, n, copy); });
+        return m_data + index;
+    }
+
+    /*
+    A forward range is counted first, so the buffer grows at most once and the elements
+    are constructed in their places. An input range can be read only once, its elements
+    are inserted one by one.
+    */
+    template <typename InputIt, typename = std::enable_if_t<std::is_base_of_v<std::input_iterator_tag, typename std::iterator_traits<InputIt>::iterator_category>>>
+    iterator insert(const_iterator pos, InputIt first, InputIt last)
+    {
+        const size_type index = static_cast<size_type>(pos - m_data);
+
+        if constexpr (!std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<InputIt>::iterator_category>)
+        {
+            for (size_type i = index; first != last; ++first, ++i)
+                emplace(m_data + i, *first);
+        }
+        else
+        {
+            const size_type count = static_cast<size_type>(std::distance(first, last));
+            if (count == 0) return m_data + index;
+
+            if (m_size + count > m_capacity)
+                reallocate(grown_capacity(m_size + count), index, count, [&](T* place) { construct_copies(place, count, first); });
+            else
+            {
+                // Both functions get the part of the range that goes to the given place, it starts at first + skip
+                InputIt next = first;
+                size_type position = 0;
+                auto part = [&](size_type skip, size_type n) {
+                    if (skip < position) { next = first; position = 0; }
+                    std::advance(next, skip - position);
+                    position = skip + n;
+                    InputIt part_first = next;
+                    std::advance(next, n);
+                    return part_first;
+                };
+                insert_in_place(index, count, [&](T* place, size_type n) { construct_copies(place, n, part(count - n, n)); },
+                                              [&](T* place, size_type n) { std::copy_n(part(0, n), n, place); });
+            }
+        }
+        return m_data + index;
+    }
+
+    iterator insert(const_iterator pos, std::initializer_list<T> list)
+    {
+        return insert(pos, list.begin(), list.end());
+    }
+
+    iterator erase(const_iterator pos)
+    {
+        return erase(pos, pos + 1);
+    }
+
+    iterator erase(const_iterator first, const_iterator last)
+    {
+        const size_type index = static_cast<size_type>(first - m_data);
+        const size_type count = static_cast<size_type>(last - first);
+        if (count == 0) return m_data + index;
+
+        std::move(m_data + index + count, m_data + m_size, m_data + index);
+        destroy(m_data + m_size - count, m_data + m_size);
+        m_size -= count;
+        return m_data + index;
+    }
+
+    // New elements are value-initialized (zeroes for numbers)
+    void resize(size_type new_size)
+    {
+        if (new_size <= m_size)
+        {
+            destroy(m_data + new_size, m_data + m_size);
+            m_size = new_size;
+        }
+        else if (new_size > m_capacity)
+        {
+            reallocate(grown_capacity(new_size), m_size, new_size - m_size, [&](T* place) {
+                construct_each(place, new_size - m_size, [&](T* p) { construct(p); });
+            });
+        }
+        else
+        {
+            construct_each(m_data + m_size, new_size - m_size, [&](T* p) { construct(p); });
+            m_size = new_size;
+        }
+    }
 
-        new (m_data + m_size) T(std::move(value));
-        ++m_size;
+    void resize(size_type new_size, const T& value)
+    {
+        if (new_size <= m_size)
+            resize(new_size);
+        else
+            insert(end(), new_size - m_size, value);
     }
 
     T& operator[](size_type index) { return *(m_data + index); }
@@ -99,7 +408,10 @@ public:
     friend bool operator==(const MyVector& vector1, const MyVector& vector2) noexcept
     {
         if (vector1.m_size != vector2.m_size) return false;
-        return std::equal(vector1.begin(), vector1.end(), vector2.begin());
+        if constexpr (is_bitwise_comparable<T>)
+            return simd_equal(vector1.m_data, vector2.m_data, vector1.m_size);
+        else
+            return std::equal(vector1.begin(), vector1.end(), vector2.begin());
     }
 
     friend bool operator!=(const MyVector& vector1, const MyVector& vector2) noexcept
@@ -107,39 +419,90 @@ public:
         return !(vector1 == vector2);
     }
 
+    iterator find(const T& value)
+    {
+        return m_data + (std::as_const(*this).find(value) - m_data);
+    }
+
+    const_iterator find(const T& value) const
+    {
+        if constexpr (is_bitwise_comparable<T>)
+            return m_data + simd_find(m_data, m_size, value);
+        else
+            return std::find(begin(), end(), value);
+    }
+
+    size_type count(const T& value) const
+    {
+        if constexpr (is_bitwise_comparable<T>)
+            return simd_count(m_data, m_size, value);
+        else
+            return static_cast<size_type>(std::count(begin(), end(), value));
+    }
+
+    bool contains(const T& value) const
+    {
+        return find(value) != end();
+    }
+
     void reserve(const size_type& new_capacity)
     {
         if (new_capacity > m_capacity)
+            reallocate(new_capacity, m_size, 0, [](T*) {});
+    }
+
+    void shrink_to_fit()
+    {
+        if (m_size == m_capacity || is_inline()) return;
+
+        if (m_size == 0)
+            release();
+        else if (m_size <= InlineCapacity)
         {
-            T* new_data = static_cast<T*>(operator new(sizeof(T) * new_capacity));
-            for (size_t i = 0; i < m_size; i++)
-                new (new_data + i) T(m_data[i]);
-            if (m_size > 0)
-                std::destroy(m_data, m_data + m_size);
-            if (m_data != nullptr)
-                operator delete(m_data);
-            m_data = new_data;
-            m_capacity = new_capacity;
+            // Back to the inline storage
+            T* heap_data = m_data;
+            const size_type heap_capacity = m_capacity;
+            transfer(heap_data, m_size, m_inline.data());
+            if constexpr (!std::is_trivially_copyable_v<T>)
+                destroy(heap_data, heap_data + m_size);
+            alloc_traits::deallocate(m_alloc, heap_data, heap_capacity);
+            m_data = m_inline.data();
+            m_capacity = InlineCapacity;
         }
+        else
+            reallocate(m_size, m_size, 0, [](T*) {});
     }
 
     void clear()
     {
         if (m_size > 0)
-            std::destroy(m_data, m_data + m_size);
+            destroy(m_data, m_data + m_size);
         m_size = 0;
     }
 
     void release()
     {
         clear();
-        if (m_data != nullptr)
-            operator delete(m_data);
+        if (m_data != nullptr && !is_inline())
+            alloc_traits::deallocate(m_alloc, m_data, m_capacity);
         set_default();
     }
 
+    // The allocators are swapped only if the allocator type says so, otherwise they must be equal
     void swap(MyVector& other)
     {
+        if (is_inline() || other.is_inline())
+        {
+            MyVector temp(std::move(other));
+            other.release();
+            other.steal(*this);
+            release();
+            steal(temp);
+            return;
+        }
+
+        if constexpr (alloc_traits::propagate_on_container_swap::value)
+            std::swap(m_alloc, other.m_alloc);
         std::swap(m_data, other.m_data);
         std::swap(m_size, other.m_size);
         std::swap(m_capacity, other.m_capacity);
@@ -151,21 +514,205 @@ public:
 
         if (other.m_size == 0) return;
 
-        reserve(other.m_size);
-        m_size = other.m_size;
-        for (size_type i = 0; i < other.m_size; i++)
-            new(m_data + i) T(other.m_data[i]);
+        if (other.m_size <= m_capacity)
+        {
+            construct_copies(m_data, other.m_size, other.m_data);
+            m_size = other.m_size;
+        }
+        else
+            reallocate(other.m_size, 0, other.m_size, [&](T* place) { construct_copies(place, other.m_size, other.m_data); });
     }
 
     void set_default()
     {
-        m_data = nullptr;
+        m_data = m_inline.data();
         m_size = 0;
-        m_capacity = 0;
+        m_capacity = InlineCapacity;
+    }
+
+    // True when the elements are stored inside the object (SmallVector)
+    bool is_inline() const
+    {
+        if constexpr (InlineCapacity > 0)
+            return m_data == m_inline.data();
+        else
+            return false;
     }
 
 private:
-    T* m_data = nullptr;
+    size_type grown_capacity(size_type required) const
+    {
+        return std::max(required, m_capacity * 2);
+    }
+
+    // Takes the buffer of a vector with an equal allocator, this vector must be empty and without a heap buffer.
+    // Inline elements can't be taken, they are moved into the inline storage of this vector
+    void steal(MyVector& other)
+    {
+        if (other.is_inline())
+        {
+            transfer(other.m_data, other.m_size, m_data);
+            m_size = other.m_size;
+            other.clear();
+            return;
+        }
+
+        m_data = other.m_data;
+        m_size = other.m_size;
+        m_capacity = other.m_capacity;
+        other.set_default();
+    }
+
+    void move_elements(MyVector& other)
+    {
+        clear();
+        reserve(other.m_size);
+        for (T& obj : other)
+            emplace_back(std::move(obj));
+        other.clear();
+    }
+
+    template <typename... Args>
+    void construct(T* place, Args&&... args)
+    {
+        alloc_traits::construct(m_alloc, place, std::forward<Args>(args)...);
+    }
+
+    void destroy(T* first, T* last)
+    {
+        if constexpr (!std::is_trivially_destructible_v<T>)
+            for (; first != last; ++first)
+                alloc_traits::destroy(m_alloc, first);
+    }
+
+    // make(place) constructs one object. If it throws, the objects made before are destroyed
+    template <typename Make>
+    void construct_each(T* place, size_type count, Make&& make)
+    {
+        size_type i = 0;
+        try
+        {
+            for (; i < count; ++i)
+                make(place + i);
+        }
+        catch (...)
+        {
+            destroy(place, place + i);
+            throw;
+        }
+    }
+
+    template <typename InputIt>
+    void construct_copies(T* place, size_type count, InputIt first)
+    {
+        construct_each(place, count, [&](T* p) { construct(p, *first); ++first; });
+    }
+
+    /*
+    Moves the elements to a new buffer of new_capacity and leaves a gap of count elements
+    at index, which construct(place) fills. The gap is filled first, then the old elements
+    are transferred. If anything throws, the new buffer is freed and the vector is unchanged.
+    */
+    template <typename Construct>
+    void reallocate(size_type new_capacity, size_type index, size_type count, Construct&& construct)
+    {
+        T* new_data = alloc_traits::allocate(m_alloc, new_capacity);
+        try
+        {
+            construct(new_data + index);
+            try
+            {
+                transfer(m_data, index, new_data);
+                try
+                {
+                    transfer(m_data + index, m_size - index, new_data + index + count);
+                }
+                catch (...)
+                {
+                    destroy(new_data, new_data + index);
+                    throw;
+                }
+            }
+            catch (...)
+            {
+                destroy(new_data + index, new_data + index + count);
+                throw;
+            }
+        }
+        catch (...)
+        {
+            alloc_traits::deallocate(m_alloc, new_data, new_capacity);
+            throw;
+        }
+
+        if constexpr (!std::is_trivially_copyable_v<T>)
+            destroy(m_data, m_data + m_size);
+        if (m_data != nullptr && !is_inline())
+            alloc_traits::deallocate(m_alloc, m_data, m_capacity);
+        m_data = new_data;
+        m_size += count;
+        m_capacity = new_capacity;
+    }
+
+    /*
+    Moves count objects to uninitialized memory, the old objects are not destroyed.
+    Trivially copyable objects are copied with one memcpy. Other objects are moved if
+    the move can't throw, otherwise copied, so a throwing copy leaves the old objects as they were.
+    */
+    void transfer(T* from, size_type count, T* to)
+    {
+        if (count == 0) return;
+
+        if constexpr (std::is_trivially_copyable_v<T>)
+            std::memcpy(static_cast<void*>(to), static_cast<const void*>(from), sizeof(T) * count);
+        else if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>)
+            construct_each(to, count, [&](T* p) { construct(p, std::move(from[p - to])); });
+        else
+            construct_copies(to, count, from);
+    }
+
+    /*
+    Inserts count elements at index when they fit into the capacity. The tail is shifted
+    right by count, construct(place, n) makes the n last new elements in the uninitialized
+    memory after the old end, assign(place, n) writes the n first new elements over the
+    moved-from ones.
+    */
+    template <typename Construct, typename Assign>
+    void insert_in_place(size_type index, size_type count, Construct&& construct, Assign&& assign)
+    {
+        T* const pos = m_data + index;
+        T* const old_end = m_data + m_size;
+        const size_type after = m_size - index;
+
+        if (after > count)
+        {
+            construct_each(old_end, count, [&](T* p) { this->construct(p, std::move(*(p - count))); });
+            m_size += count;
+            std::move_backward(pos, old_end - count, old_end);
+            assign(pos, count);
+        }
+        else
+        {
+            construct(old_end, count - after);
+            m_size += count - after;
+            construct_each(pos + count, after, [&](T* p) { this->construct(p, std::move(*(p - count))); });
+            m_size += after;
+            assign(pos, after);
+        }
+    }
+
+    [[no_unique_address]] Alloc m_alloc{};
+    [[no_unique_address]] MyVectorInlineStorage<T, InlineCapacity> m_inline;
+    T* m_data = m_inline.data();
     size_type m_size{};
-    size_type m_capacity{};
-};
\ No newline at end of file
+    size_type m_capacity = InlineCapacity;
+};
+
+
+// MyVector whose memory comes from a std::pmr::memory_resource
+template <typename T>
+using PmrMyVector = MyVector<T, std::pmr::polymorphic_allocator<T>>;
+
+// MyVector that keeps up to N elements inside the object
+template <typename T, std::size_t N, typename Alloc = std::allocator<T>>
+using SmallVector = MyVector<T, Alloc, N>;
@@ -0,0 +1,267 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <exception>
+#include <type_traits>
+#include <utility>
+#include <span>
+
+#include "serialize_buffer.hpp"
+#include "serialize_encoding.hpp"
+
+/*
+Parallel chunked serialization of large sequential containers with random access.
+serialize_parallel() needs size() and operator[], deserialize_parallel() also needs
+clear() and resize() (std::vector, std::deque, ...).
+
+The container is split into chunks. The size of every chunk is computed first, so the
+chunk index is written before the chunks, then every worker thread encodes its chunks
+straight into their place behind the index (into the memory of the writer when it has
+extend(), into one temporary block otherwise).
+The index lets the decoder find every chunk without decoding the previous ones, so the
+decoding fans out across threads too.
+
+Format (numbers are written with serialize(), so they follow the encoding of the writer):
+    uint32_t  number of elements
+    uint32_t  number of chunks
+    for every chunk:   uint32_t number of elements, uint64_t number of bytes
+    the chunks: the elements of every chunk written one after another
+
+This is a different format from serialize(): a container written by serialize_parallel()
+must be read by deserialize_parallel().
+*/
+
+
+constexpr std::size_t DEFAULT_PARALLEL_CHUNKS_PER_THREAD = 4;
+
+
+inline std::size_t default_thread_count()
+{
+    const std::size_t threads = std::thread::hardware_concurrency();
+    return threads > 0 ? threads : 1;
+}
+
+
+// Runs task(i) for every i in [0, count) on `threads` worker threads, rethrows the first exception
+template <typename Task>
+void run_parallel(std::size_t count, std::size_t threads, Task&& task)
+{
+    if (threads > count) threads = count;
+    if (threads <= 1)
+    {
+        for (std::size_t i = 0; i < count; ++i)
+            task(i);
+        return;
+    }
+
+    std::atomic<std::size_t> next{0};
+    std::exception_ptr error = nullptr;
+    std::mutex error_mutex;
+
+    auto worker = [&]() {
+        for (std::size_t i = next++; i < count; i = next++)
+        {
+            try
+            {
+                task(i);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(error_mutex);
+                if (!error) error = std::current_exception();
+                next = count;
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    for (std::size_t i = 1; i < threads; ++i)
+        workers.emplace_back(worker);
+    worker();
+
+    for (auto& thread : workers)
+        thread.join();
+
+    if (error) std::rethrow_exception(error);
+}
+
+
+
+template <typename Reader, typename = void>
+struct has_view : std::false_type{};
+
+template <typename Reader>
+struct has_view<Reader, std::void_t<decltype(std::declval<Reader&>().view(std::declval<std::size_t>()))>>
+    : std::true_type{};
+
+
+
+template <typename Writer, typename = void>
+struct has_extend : std::false_type{};
+
+template <typename Writer>
+struct has_extend<Writer, std::void_t<decltype(std::declval<Writer&>().extend(std::declval<std::size_t>()))>>
+    : std::true_type{};
+
+
+
+template <typename ContainerType, typename Writer>
+void serialize_parallel(const ContainerType& c, Writer& w, std::size_t threads = default_thread_count())
+{
+    using Encoding = encoding_of_t<Writer>;
+    static_assert(!Encoding::aligned_blocks, "Parallel serialization does not support the aligned encoding");
+
+    if (threads == 0) threads = 1;
+
+    const std::size_t len = c.size();
+    std::size_t chunk_count = threads == 1 ? 1 : threads * DEFAULT_PARALLEL_CHUNKS_PER_THREAD;
+    if (chunk_count > len) chunk_count = len > 0 ? len : 1;
+    const std::size_t chunk_size = (len + chunk_count - 1) / chunk_count;
+    if (chunk_size > 0) chunk_count = (len + chunk_size - 1) / chunk_size;
+
+    // The exact size of every chunk, so the index can be written before the chunks are encoded
+    std::vector<std::size_t> chunk_bytes(chunk_count);
+    run_parallel(chunk_count, threads, [&](std::size_t i) {
+        const std::size_t first = i * chunk_size;
+        const std::size_t last = first + chunk_size < len ? first + chunk_size : len;
+
+        std::size_t bytes = 0;
+        for (std::size_t j = first; j < last; ++j)
+            bytes += serialized_size<Encoding>(c[j]);
+        chunk_bytes[i] = bytes;
+    });
+
+    // Header and chunk index
+    serialize(static_cast<uint32_t>(len), w);
+    serialize(static_cast<uint32_t>(chunk_count), w);
+    std::vector<std::size_t> chunk_offset(chunk_count);
+    std::size_t total_bytes = 0;
+    for (std::size_t i = 0; i < chunk_count; ++i)
+    {
+        const std::size_t first = i * chunk_size;
+        const std::size_t last = first + chunk_size < len ? first + chunk_size : len;
+        serialize(static_cast<uint32_t>(last - first), w);
+        serialize(static_cast<uint64_t>(chunk_bytes[i]), w);
+
+        chunk_offset[i] = total_bytes;
+        total_bytes += chunk_bytes[i];
+    }
+
+    // Every thread encodes its chunks straight into their place in the memory of the writer,
+    // writers that can't give out their memory get all chunks with one write
+    std::vector<std::byte> storage;
+    std::byte* data = nullptr;
+    if constexpr (has_extend<Writer>::value)
+    {
+        data = w.extend(total_bytes);
+    }
+    else
+    {
+        storage.resize(total_bytes);
+        data = storage.data();
+    }
+
+    run_parallel(chunk_count, threads, [&](std::size_t i) {
+        const std::size_t first = i * chunk_size;
+        const std::size_t last = first + chunk_size < len ? first + chunk_size : len;
+
+        SpanWriter inner(std::span<std::byte>(data + chunk_offset[i], chunk_bytes[i]));
+        EncodedWriter<Encoding, SpanWriter> chunk_writer(inner);
+        for (std::size_t j = first; j < last; ++j)
+            serialize(c[j], chunk_writer);
+
+        if (inner.remaining() != 0) throw SerializeBufferError("Invalid chunk: it is shorter than its serialized_size().");
+    });
+
+    if constexpr (!has_extend<Writer>::value)
+    {
+        if (total_bytes > 0) w.write(storage.data(), total_bytes);
+    }
+}
+
+
+template <typename ContainerType, typename Reader>
+void deserialize_parallel(ContainerType& c, Reader& r, std::size_t threads = default_thread_count())
+{
+    using Encoding = encoding_of_t<Reader>;
+    static_assert(!Encoding::aligned_blocks, "Parallel serialization does not support the aligned encoding");
+
+    if (threads == 0) threads = 1;
+
+    uint32_t len = 0;
+    uint32_t chunk_count = 0;
+    deserialize(len, r);
+    deserialize(chunk_count, r);
+
+    std::vector<std::size_t> chunk_first;
+    std::vector<std::size_t> chunk_elements;
+    std::vector<std::size_t> chunk_bytes;
+    chunk_first.reserve(trusted_count<std::size_t>(r, chunk_count));
+    chunk_elements.reserve(trusted_count<std::size_t>(r, chunk_count));
+    chunk_bytes.reserve(trusted_count<std::size_t>(r, chunk_count));
+    std::size_t total_elements = 0;
+    std::size_t total_bytes = 0;
+    for (uint32_t i = 0; i < chunk_count; ++i)
+    {
+        uint32_t elements = 0;
+        uint64_t bytes = 0;
+        deserialize(elements, r);
+        deserialize(bytes, r);
+        if (reader_failed(r)) throw SerializeBufferError("Unexpected end of input: the chunk index is truncated.");
+
+        chunk_first.push_back(total_elements);
+        chunk_elements.push_back(elements);
+        chunk_bytes.push_back(static_cast<std::size_t>(bytes));
+        total_elements += elements;
+        total_bytes += static_cast<std::size_t>(bytes);
+    }
+    if (total_elements != len) throw SerializeBufferError("Invalid chunk index: the chunks don't add up to the container size.");
+
+    // All chunks are needed at once: point into the reader's buffer if it can, copy otherwise
+    std::vector<std::byte> storage;
+    const std::byte* data = nullptr;
+    if constexpr (has_view<Reader>::value)
+    {
+        data = r.view(total_bytes);
+    }
+    else
+    {
+        // Grows with the bytes that are actually read, so a corrupt index can't allocate ahead of the input
+        while (storage.size() < total_bytes && !reader_failed(r))
+        {
+            const std::size_t offset = storage.size();
+            const std::size_t step = std::max<std::size_t>(trusted_count<std::byte>(r, total_bytes - offset), 1);
+            storage.resize(offset + step);
+            r.read(storage.data() + offset, step);
+        }
+        if (reader_failed(r)) throw SerializeBufferError("Unexpected end of input: the chunks are shorter than their index.");
+        data = storage.data();
+    }
+
+    std::vector<std::size_t> chunk_offset(chunk_count);
+    std::size_t offset = 0;
+    for (uint32_t i = 0; i < chunk_count; ++i)
+    {
+        chunk_offset[i] = offset;
+        offset += chunk_bytes[i];
+    }
+
+    // Every thread decodes its chunks straight into their place in the container
+    c.clear();
+    c.resize(len);
+    run_parallel(chunk_count, threads, [&](std::size_t i) {
+        SpanReader inner(std::span<const std::byte>(data + chunk_offset[i], chunk_bytes[i]));
+        EncodedReader<Encoding, SpanReader> chunk_reader(inner);
+        for (std::size_t j = 0; j < chunk_elements[i]; ++j)
+            deserialize(c[chunk_first[i] + j], chunk_reader);
+
+        if (inner.remaining() != 0) throw SerializeBufferError("Invalid chunk: it has bytes after the last element.");
+    });
+}
@@ -0,0 +1,200 @@
+#include <iostream>
+#include <iomanip>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <forward_list>
+#include <map>
+#include "my_vector.hpp"
+
+// #include <serialize_concepts.hpp>
+// #include <serialize_sfinae.hpp>
+#include "serialize.hpp"
+#include "serialize_instrumentation.hpp"
+
+/*
+Throughput benchmark of serialize() / deserialize() for the main kinds of types. It is built
+twice, as serialize_bench_sfinae and serialize_bench_concepts, so the two implementations can
+be compared. For every case it prints MB/s of serialized data and heap allocations per call.
+
+    ./bin/serialize_bench_concepts [filter] [--min-time seconds]
+
+Only the cases whose name contains `filter` are run.
+*/
+
+
+//========================================HARNESS========================================
+
+namespace
+{
+    double g_min_time = 0.5;
+    std::string g_filter;
+
+    struct Measurement
+    {
+        double seconds_per_op;
+        double allocations_per_op;
+    };
+
+    // Makes the compiler assume the object is read, so the work that produced it is not optimized away
+    template <typename T>
+    void keep(T& value)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r"(&value) : "memory");
+#else
+        static volatile const void* sink;
+        sink = &value;
+#endif
+    }
+
+    // Repeats the operation (doubling the number of repetitions) until it takes at least g_min_time
+    template <typename Operation>
+    Measurement measure(Operation&& operation)
+    {
+        operation();
+
+        std::size_t iterations = 1;
+        while (true)
+        {
+            const ScopedSerializeCounters scope;
+            const auto start = std::chrono::steady_clock::now();
+            for (std::size_t i = 0; i < iterations; ++i)
+                operation();
+            const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            const std::size_t allocations = scope.counters().allocations;
+
+            if (seconds >= g_min_time || iterations >= (std::size_t{1} << 30))
+                return {seconds / iterations, static_cast<double>(allocations) / iterations};
+            iterations *= 2;
+        }
+    }
+
+    void print_row(const std::string& name, const std::string& operation, std::size_t bytes, const Measurement& m)
+    {
+        std::cout << std::left << std::setw(28) << name << std::setw(14) << operation << std::right
+                  << std::fixed << std::setprecision(1)
+                  << std::setw(12) << bytes / m.seconds_per_op / (1024.0 * 1024.0) << " MB/s"
+                  << std::setw(14) << m.seconds_per_op * 1e6 << " us/op"
+                  << std::setw(14) << m.allocations_per_op << " allocs/op" << std::endl;
+    }
+
+    // Serializes the object into a reused buffer, then deserializes it into a fresh object every time
+    template <typename T>
+    void bench_case(const std::string& name, const T& obj)
+    {
+        if (name.find(g_filter) == std::string::npos) return;
+
+        std::vector<std::byte> buffer;
+        buffer.reserve(serialized_size(obj));
+        const Measurement serialize_m = measure([&] {
+            buffer.clear();
+            VectorWriter w(buffer);
+            serialize(obj, w);
+            keep(buffer);
+        });
+        print_row(name, "serialize", buffer.size(), serialize_m);
+
+        const Measurement deserialize_m = measure([&] {
+            T result{};
+            SpanReader r(buffer);
+            deserialize(result, r);
+            keep(result);
+        });
+        print_row(name, "deserialize", buffer.size(), deserialize_m);
+    }
+
+    // Many small objects, one serialize() call each
+    template <typename T>
+    void bench_scalars(const std::string& name, std::size_t count, T value)
+    {
+        if (name.find(g_filter) == std::string::npos) return;
+
+        std::vector<std::byte> buffer;
+        buffer.reserve(count * sizeof(T));
+        const Measurement serialize_m = measure([&] {
+            buffer.clear();
+            VectorWriter w(buffer);
+            for (std::size_t i = 0; i < count; ++i)
+                serialize(value, w);
+            keep(buffer);
+        });
+        print_row(name, "serialize", buffer.size(), serialize_m);
+
+        const Measurement deserialize_m = measure([&] {
+            SpanReader r(buffer);
+            T result{};
+            for (std::size_t i = 0; i < count; ++i)
+                deserialize(result, r);
+            keep(result);
+        });
+        print_row(name, "deserialize", buffer.size(), deserialize_m);
+    }
+}
+
+
+
+int main(int argc, char** argv)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if (arg == "--min-time" && i + 1 < argc)
+            g_min_time = std::atof(argv[++i]);
+        else
+            g_filter = arg;
+    }
+
+#ifdef USE_CONCEPTS
+    std::cout << "serialize_bench: concepts implementation" << std::endl;
+#else
+    std::cout << "serialize_bench: SFINAE implementation" << std::endl;
+#endif
+
+    bench_scalars<uint64_t>("scalars uint64 x1M", 1'000'000, 0x0123456789ABCDEFull);
+    bench_scalars<double>("scalars double x1M", 1'000'000, 3.14159);
+
+    bench_case("string 1MB", std::string(1024 * 1024, 'x'));
+
+    {
+        std::vector<int> vec(1'000'000);
+        for (std::size_t i = 0; i < vec.size(); ++i)
+            vec[i] = static_cast<int>(i * 7);
+        bench_case("vector<int> 1M", vec);
+    }
+    {
+        std::vector<std::string> vec;
+        for (int i = 0; i < 100'000; ++i)
+            vec.push_back("string number " + std::to_string(i));
+        bench_case("vector<string> 100K", vec);
+    }
+    {
+        std::forward_list<int> list;
+        for (int i = 0; i < 100'000; ++i)
+            list.push_front(i);
+        bench_case("forward_list<int> 100K", list);
+    }
+    {
+        std::map<std::string, int> map;
+        for (int i = 0; i < 100'000; ++i)
+            map["key " + std::to_string(i)] = i;
+        bench_case("map<string, int> 100K", map);
+    }
+    {
+        MyVector<int> my_vector;
+        for (int i = 0; i < 1'000'000; ++i)
+            my_vector.push_back(i);
+        bench_case("MyVector<int> 1M", my_vector);
+    }
+    {
+        MyVector<std::string> my_vector;
+        for (int i = 0; i < 100'000; ++i)
+            my_vector.push_back("string number " + std::to_string(i));
+        bench_case("MyVector<string> 100K", my_vector);
+    }
+
+    return 0;
+}
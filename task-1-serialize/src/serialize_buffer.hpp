@@ -0,0 +1,226 @@
+#pragma once
+
+#include <iostream>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <vector>
+#include <span>
+#include <string>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+/*
+Writers and readers are the sinks and sources of bytes for serialize() and deserialize().
+
+A writer is any type with a method  void write(const std::byte* data, std::size_t size),
+a reader is any type with a method  void read(std::byte* data, std::size_t size).
+Readers over memory also have  const std::byte* view(std::size_t size)  that returns a pointer
+to the next bytes without copying them (used to deserialize std::string_view / std::span).
+Writers over memory have  std::byte* extend(std::size_t size)  that appends size bytes and
+returns where they start, so the caller can fill them in place (used by serialize_parallel()).
+Serializers only work with this interface, so new backings can be added without touching
+them. The std::ostream / std::istream overloads of serialize() and deserialize() are thin
+adapters that use StreamWriter / StreamReader.
+*/
+
+
+class SerializeBufferError : public std::runtime_error {
+public:
+    explicit SerializeBufferError(const std::string& message)
+        : std::runtime_error(message) {}
+};
+
+
+
+//======================================WRITERS======================================
+
+// Appends bytes to the end of a growable byte vector
+class VectorWriter
+{
+public:
+    explicit VectorWriter(std::vector<std::byte>& buffer) : m_buffer(buffer) {}
+
+    void write(const std::byte* data, std::size_t size)
+    {
+        m_buffer.insert(m_buffer.end(), data, data + size);
+    }
+
+    // The new bytes are zeroed, the pointer is valid until the next write
+    std::byte* extend(std::size_t size)
+    {
+        const std::size_t old_size = m_buffer.size();
+        m_buffer.resize(old_size + size);
+        return m_buffer.data() + old_size;
+    }
+
+    std::size_t size() const { return m_buffer.size(); }
+    std::size_t position() const { return m_buffer.size(); }
+
+private:
+    std::vector<std::byte>& m_buffer;
+};
+
+
+// Writes bytes into a fixed memory block. Writing past its end throws SerializeBufferError
+class SpanWriter
+{
+public:
+    explicit SpanWriter(std::span<std::byte> buffer) : m_buffer(buffer) {}
+
+    void write(const std::byte* data, std::size_t size)
+    {
+        std::memcpy(extend(size), data, size);
+    }
+
+    std::byte* extend(std::size_t size)
+    {
+        if (size > m_buffer.size() - m_position)
+        {
+            std::string message = "Buffer overflow: cannot write ";
+            message += std::to_string(size);
+            message += " bytes, only ";
+            message += std::to_string(m_buffer.size() - m_position);
+            message += " bytes are left.";
+            throw SerializeBufferError(message);
+        }
+
+        std::byte* result = m_buffer.data() + m_position;
+        m_position += size;
+        return result;
+    }
+
+    std::size_t position() const { return m_position; }
+    std::size_t remaining() const { return m_buffer.size() - m_position; }
+
+private:
+    std::span<std::byte> m_buffer;
+    std::size_t m_position = 0;
+};
+
+
+// Writes bytes straight into the streambuf of a std::ostream, sets badbit on failure
+class StreamWriter
+{
+public:
+    explicit StreamWriter(std::ostream& os) : m_stream(os) {}
+
+    void write(const std::byte* data, std::size_t size)
+    {
+        std::streambuf* buf = m_stream.rdbuf();
+        const std::streamsize count = static_cast<std::streamsize>(size);
+        if (!m_stream.good() || buf == nullptr || buf->sputn(reinterpret_cast<const char*>(data), count) != count)
+            m_stream.setstate(std::ios::badbit);
+    }
+
+private:
+    std::ostream& m_stream;
+};
+
+
+
+//======================================READERS======================================
+
+// Reads bytes from a memory block. Reading past its end throws SerializeBufferError
+class SpanReader
+{
+public:
+    explicit SpanReader(std::span<const std::byte> buffer) : m_buffer(buffer) {}
+
+    void read(std::byte* data, std::size_t size)
+    {
+        std::memcpy(data, view(size), size);
+    }
+
+    // Skips the next bytes and returns a pointer to them inside the buffer
+    const std::byte* view(std::size_t size)
+    {
+        if (size > m_buffer.size() - m_position)
+        {
+            std::string message = "Unexpected end of buffer: cannot read ";
+            message += std::to_string(size);
+            message += " bytes, only ";
+            message += std::to_string(m_buffer.size() - m_position);
+            message += " bytes are left.";
+            throw SerializeBufferError(message);
+        }
+
+        const std::byte* data = m_buffer.data() + m_position;
+        m_position += size;
+        return data;
+    }
+
+    std::size_t position() const { return m_position; }
+    std::size_t remaining() const { return m_buffer.size() - m_position; }
+
+private:
+    std::span<const std::byte> m_buffer;
+    std::size_t m_position = 0;
+};
+
+
+// Reads bytes straight from the streambuf of a std::istream, sets failbit and eofbit on a short read
+class StreamReader
+{
+public:
+    explicit StreamReader(std::istream& is) : m_stream(is) {}
+
+    void read(std::byte* data, std::size_t size)
+    {
+        std::streambuf* buf = m_stream.rdbuf();
+        const std::streamsize count = static_cast<std::streamsize>(size);
+        if (!m_stream.good() || buf == nullptr || buf->sgetn(reinterpret_cast<char*>(data), count) != count)
+            m_stream.setstate(std::ios::failbit | std::ios::eofbit);
+    }
+
+    bool failed() const { return m_stream.fail(); }
+
+private:
+    std::istream& m_stream;
+};
+
+
+// Readers that don't throw on a short read (StreamReader) report it with failed()
+template <typename Reader, typename = void>
+struct has_failed : std::false_type{};
+
+template <typename Reader>
+struct has_failed<Reader, std::void_t<decltype(std::declval<const Reader&>().failed())>>
+    : std::true_type{};
+
+template <typename Reader>
+bool reader_failed(const Reader& r)
+{
+    if constexpr (has_failed<Reader>::value)
+        return r.failed();
+    else
+        return false;
+}
+
+
+// Readers of a memory block (SpanReader, MappedFileReader) know how many bytes are left
+template <typename Reader, typename = void>
+struct has_remaining : std::false_type{};
+
+template <typename Reader>
+struct has_remaining<Reader, std::void_t<decltype(std::declval<const Reader&>().remaining())>>
+    : std::true_type{};
+
+// Without remaining() a container grows by this many bytes of elements at a time
+constexpr std::size_t UNTRUSTED_GROWTH_BYTES = std::size_t{1} << 20;
+
+/*
+How many of count elements of T may be allocated before they are read. A corrupt length must not
+allocate gigabytes: the count is capped by the bytes left in the input, min_wire_size bytes per
+element, or by UNTRUSTED_GROWTH_BYTES when the reader doesn't know its size.
+*/
+template <typename T, typename Reader>
+std::size_t trusted_count(const Reader& r, std::size_t count, std::size_t min_wire_size = 1)
+{
+    if constexpr (has_remaining<Reader>::value)
+        return std::min(count, r.remaining() / min_wire_size);
+    else
+        return std::min(count, std::max<std::size_t>(UNTRUSTED_GROWTH_BYTES / sizeof(T), 1));
+}
@@ -6,8 +6,16 @@
 #include <cstdint>
 #include <type_traits>
 #include <concepts>
+#include <memory>
+#include <utility>
 
 #include <string>
+#include <string_view>
+#include <span>
+
+#include "serialize_buffer.hpp"
+#include "serialize_encoding.hpp"
+#include "serialize_fields.hpp"
 
 
 //======================================CONCEPTS======================================
@@ -52,50 +60,114 @@ concept ForwardListContainer = !String<ContainerType> && requires(ContainerType&
 };
 
 
+template <typename Writer>
+concept BufferWriter = requires(Writer& w, const std::byte* data, std::size_t size)
+{
+    w.write(data, size);
+};
+
+
+template <typename Reader>
+concept BufferReader = requires(Reader& r, std::byte* data, std::size_t size)
+{
+    r.read(data, size);
+};
+
+
+template <typename Reader>
+concept BufferViewReader = BufferReader<Reader> && requires(Reader& r, std::size_t size)
+{
+    { r.view(size) } -> std::same_as<const std::byte*>;
+};
+
+
+/*
+Trivially copyable objects are written by the base serializer as their raw bytes, so 
+a whole range of them can be written (and read back) with one call instead of a loop.
+std::pair, views and structs listed with SERIALIZE_FIELDS are trivially copyable too, 
+but they have their own serializers, so they are excluded (see is_raw_serializable).
+*/
+template <typename T>
+concept BitwiseSerializable = is_raw_serializable<T>::value;
+
+
+template <typename T>
+concept ReflectedStruct = has_serialize_fields<T>::value;
+
+
+template <typename ContainerType>
+concept ContiguousBitwiseContainer = StandartContainer<ContainerType> 
+    && std::contiguous_iterator<typename ContainerType::const_iterator>
+    && BitwiseSerializable<typename ContainerType::value_type>;
+
+
+template <typename ContainerType>
+concept ResizableBitwiseContainer = SequentialContainer<ContainerType> 
+    && ContiguousBitwiseContainer<ContainerType>
+    && requires(ContainerType& c, typename ContainerType::size_type n)
+{
+    c.resize(n);
+};
+
+
 
 
 
 
 //===========================SERIALIZE/DESERIALIZE DECLARATIONS===========================
 
+template <typename T, BufferWriter Writer>
+void serialize(const T& obj, Writer& w);
+
+template <typename T, BufferReader Reader>
+void deserialize(T& obj, Reader& r);
+
 template <typename T>
 void serialize(const T& obj, std::ostream& os);
 
 template <typename T>
 void deserialize(T& obj, std::istream& is);
 
+// The core calls serialize() / deserialize() for the elements, so it goes after their declarations
+#include "serialize_core.hpp"
+
+
 
 
 
 //==================ALL SERIALIZER/DESERIALIZER TEMPLATES IMPLEMETATIONS==================
+/*
+The specializations only choose the kind of the object, the work is done by the functions
+of serialize_core.hpp, which are shared with the SFINAE version.
+*/
 
 template <typename T>
 struct serializer
 {
-    static void apply(const T& obj, std::ostream& os)
+    template <BufferWriter Writer>
+    static void apply(const T& obj, Writer& w)
     {
         // std::cout << "Using concepts serializer" << std::endl;
 
-        const uint8_t* ptr = reinterpret_cast<const uint8_t *>(&obj);
-
-        std::ostream_iterator<uint8_t> oi(os);
+        write_object(obj, w);
+    }
 
-        std::copy(ptr, ptr + sizeof(T), oi);
+    template <typename Encoding>
+    static std::size_t size(const T& obj)
+    {
+        return object_size<Encoding>(obj);
     }
 };
 
 template <typename T>
 struct deserializer
 {
-    static void apply(T& val, std::istream& is)
+    template <BufferReader Reader>
+    static void apply(T& val, Reader& r)
     {
         // std::cout << "Using base deserializer" << std::endl;
 
-        uint8_t* ptr = reinterpret_cast<uint8_t*>(&val);
-
-        std::istream_iterator<uint8_t> ii(is);
-
-        std::copy_n(ii, sizeof(T), ptr);
+        read_object(val, r);
     }
 };
 
@@ -108,43 +180,69 @@ represent the charachters of the string, but also the size of the string.
 template <>
 struct serializer<std::string>
 {
-    static void apply(const std::string& str, std::ostream& os)
+    template <BufferWriter Writer>
+    static void apply(const std::string& str, Writer& w)
     {
         // std::cout << "Using string serializer" << std::endl;
 
-        // Write the len of the string
-        const uint32_t len = static_cast<uint32_t>(str.size());
-        serialize(len, os);
-
-        if (len > 0)
-        {
-            // Write the data of the string
-            std::ostream_iterator<uint8_t> oi(os, "");
-            const uint8_t* data_ptr = reinterpret_cast<const uint8_t*>(str.data());
-            std::copy(data_ptr, data_ptr + len, oi);
-        }
+        write_chars(str, w);
+    }
+
+    template <typename Encoding>
+    static std::size_t size(const std::string& str)
+    {
+        return chars_size<Encoding>(str);
     }
 };
 
 template <>
 struct deserializer<std::string>
 {
-    static void apply(std::string& str, std::istream& is)
+    template <BufferReader Reader>
+    static void apply(std::string& str, Reader& r)
     {
         // std::cout << "Using string deserializer" << std::endl;
 
-        // Read the len of the string
-        uint32_t len = 0;
-        deserialize(len, is);
-
-        if (len > 0)
-        {
-            // Read the characters
-            str.clear();
-            str.resize(len);
-            std::istream_iterator<char> ii(is);
-            std::copy_n(ii, static_cast<size_t>(len), str.data());
-        }
+        read_string(str, r);
+    }
+};
+
+
+
+// ===Zero-copy views===
+/*
+std::string_view and std::span<const T> are written by the serializers of serialize_core.hpp, 
+which are shared with the SFINAE version, so they have the same format as std::string and 
+std::vector<T>. They are deserialized without copying: the view points into the buffer 
+of the reader, so the buffer must outlive the view and the reader must have view().
+*/
+template <>
+struct serializer<std::string_view> : string_view_serializer{};
+
+template <BitwiseSerializable T>
+struct serializer<std::span<const T>> : span_serializer<T>{};
+
+template <>
+struct deserializer<std::string_view>
+{
+    template <BufferViewReader Reader>
+    static void apply(std::string_view& str, Reader& r)
+    {
+        // std::cout << "Using string_view deserializer" << std::endl;
+
+        read_string_view(str, r);
+    }
+};
+
+template <BitwiseSerializable T>
+struct deserializer<std::span<const T>>
+{
+    template <BufferViewReader Reader>
+    static void apply(std::span<const T>& span, Reader& r)
+    {
+        // std::cout << "Using span deserializer" << std::endl;
+
+        read_span(span, r);
     }
 };
 
@@ -158,26 +256,67 @@ realized separate serializer and deserializer for std::map using concept MapCont
 template <typename T1, typename T2>
 struct serializer<std::pair<T1, T2>>
 {
-    static void apply(const std::pair<T1, T2>& pair, std::ostream& os)
+    template <BufferWriter Writer>
+    static void apply(const std::pair<T1, T2>& pair, Writer& w)
     {
         // std::cout << "Using pair serializer" << std::endl;
 
-        serialize(pair.first, os);
-        serialize(pair.second, os);
+        write_pair(pair, w);
+    }
+
+    template <typename Encoding>
+    static std::size_t size(const std::pair<T1, T2>& pair)
+    {
+        return pair_size<Encoding>(pair);
     }
 };
 
 template <typename T1, typename T2>
 struct deserializer<std::pair<const T1, T2>>
 {
-    static void apply(std::pair<const T1, T2>& pair, std::istream& is)
+    template <BufferReader Reader>
+    static void apply(std::pair<const T1, T2>& pair, Reader& r)
     {
         // std::cout << "Using pair deserializer" << std::endl;
-        T1 volatile_key{};
-        deserialize(volatile_key, is);
-        T1* pair_first_ptr = const_cast<T1*>(&(pair.first));
-        *pair_first_ptr = volatile_key;
-        deserialize(pair.second, is);
+
+        read_pair(pair, r);
+    }
+};
+
+
+
+// ===User structs listed with SERIALIZE_FIELDS===
+/*
+The fields are written one by one in the order of the list, runs of adjacent trivially
+copyable fields are copied with one call (see serialize_fields.hpp).
+*/
+template <ReflectedStruct T>
+struct serializer<T>
+{
+    template <BufferWriter Writer>
+    static void apply(const T& obj, Writer& w)
+    {
+        // std::cout << "Using serializer for listed fields" << std::endl;
+
+        write_fields(obj, w);
+    }
+
+    template <typename Encoding>
+    static std::size_t size(const T& obj)
+    {
+        return fields_size<Encoding>(obj);
+    }
+};
+
+template <ReflectedStruct T>
+struct deserializer<T>
+{
+    template <BufferReader Reader>
+    static void apply(T& obj, Reader& r)
+    {
+        // std::cout << "Using deserializer for listed fields" << std::endl;
+
+        read_fields(obj, r);
     }
 };
 
@@ -187,63 +326,77 @@ struct deserializer<std::pair<const T1, T2>>
 template <StandartContainer ContainerType>
 struct serializer<ContainerType>
 {
-    static void apply(const ContainerType& c, std::ostream& os)
+    template <BufferWriter Writer>
+    static void apply(const ContainerType& c, Writer& w)
     {
         // std::cout << "Using serializer for standart container" << std::endl;
 
-        // Write the len of the container
-        const uint32_t len = static_cast<uint32_t>(c.size());
-        serialize(len, os);
+        write_elements(c, static_cast<uint32_t>(c.size()), w);
+    }
 
-        // Write objects
-        for (const auto& obj : c)
-            serialize(obj, os);
+    template <typename Encoding>
+    static std::size_t size(const ContainerType& c)
+    {
+        return elements_size<Encoding>(c, static_cast<uint32_t>(c.size()));
     }
 };
 
-template <SequentialContainer ContainerType>
+// ===Contiguous containers of trivially copyable objects===
+/*
+The bytes are the same as if every element was written by the base serializer, 
+so the format does not depend on which specialization was used.
+*/
+template <ContiguousBitwiseContainer ContainerType>
+struct serializer<ContainerType>
+{
+    template <BufferWriter Writer>
+    static void apply(const ContainerType& c, Writer& w)
+    {
+        // std::cout << "Using serializer for contiguous container" << std::endl;
+
+        write_block(std::to_address(c.begin()), static_cast<uint32_t>(c.size()), w);
+    }
+
+    template <typename Encoding>
+    static std::size_t size(const ContainerType& c)
+    {
+        return block_size<Encoding>(std::to_address(c.begin()), static_cast<uint32_t>(c.size()));
+    }
+};
+
+template <ResizableBitwiseContainer ContainerType>
 struct deserializer<ContainerType>
 {
-    static void apply(ContainerType& c, std::istream& is)
+    template <BufferReader Reader>
+    static void apply(ContainerType& c, Reader& r)
     {
-        // std::cout << "Using deserializer for sequential container" << std::endl;
+        // std::cout << "Using deserializer for contiguous container" << std::endl;
 
-        c.clear();
+        read_block(c, r);
+    }
+};
 
-        // Read the len of container
-        uint32_t len = 0;
-        deserialize(len, is);
+template <SequentialContainer ContainerType>
+struct deserializer<ContainerType>
+{
+    template <BufferReader Reader>
+    static void apply(ContainerType& c, Reader& r)
+    {
+        // std::cout << "Using deserializer for sequential container" << std::endl;
 
-        // Read objects
-        for (uint32_t i = 0; i < len; i++)
-        {
-            typename ContainerType::value_type obj{};
-            deserialize(obj, is);
-            c.push_back(obj);
-        }
+        read_sequential<ContiguousBitwiseContainer<ContainerType>>(c, r);
     }
 };
 
 template <AssociativeContainer ContainerType>
 struct deserializer<ContainerType>
 {
-    static void apply(ContainerType& c, std::istream& is)
+    template <BufferReader Reader>
+    static void apply(ContainerType& c, Reader& r)
     {
         // std::cout << "Using deserializer for associative container" << std::endl;
 
-        c.clear();
-
-        // Read the len of container
-        uint32_t len = 0;
-        deserialize(len, is);
-
-        // Read objects
-        for (uint32_t i = 0; i < len; i++)
-        {
-            typename ContainerType::value_type obj{};
-            deserialize(obj, is);
-            c.insert(obj);
-        }
+        read_associative(c, r);
     }
 };
 
@@ -251,7 +404,8 @@ struct deserializer<ContainerType>
 template <ForwardListContainer ContainerType>
 struct serializer<ContainerType>
 {
-    static void apply(const ContainerType& c, std::ostream& os)
+    template <BufferWriter Writer>
+    static void apply(const ContainerType& c, Writer& w)
     {
         // std::cout << "Using serializer for forward_list container" << std::endl;
 
@@ -259,12 +413,13 @@ struct serializer<ContainerType>
         // uint32_t len = 0;
         // for (const auto& obj : c)
         //     ++len;
-        uint32_t len = static_cast<uint32_t>(std::distance(c.begin(), c.end()));
-        serialize(len, os);
+        write_elements(c, static_cast<uint32_t>(std::distance(c.begin(), c.end())), w);
+    }
 
-        // Write objects
-        for (const auto& obj : c)
-            serialize(obj, os);
+    template <typename Encoding>
+    static std::size_t size(const ContainerType& c)
+    {
+        return elements_size<Encoding>(c, static_cast<uint32_t>(std::distance(c.begin(), c.end())));
     }
 };
 
@@ -272,25 +427,12 @@ struct serializer<ContainerType>
 template <ForwardListContainer ContainerType>
 struct deserializer<ContainerType>
 {
-    static void apply(ContainerType& c, std::istream& is)
+    template <BufferReader Reader>
+    static void apply(ContainerType& c, Reader& r)
     {
         // std::cout << "Using deserializer for forward_list container" << std::endl;
 
-        c.clear();
-
-        // Read the len of container
-        uint32_t len = 0;
-        deserialize(len, is);
-
-        // Read objects
-        auto it = c.before_begin();
-        for (uint32_t i = 0; i < len; i++)
-        {
-            typename ContainerType::value_type obj{};
-            deserialize(obj, is);
-            c.insert_after(it, obj);
-            ++it;
-        }
+        read_forward_list(c, r);
     }
 };
 
@@ -299,14 +441,35 @@ struct deserializer<ContainerType>
 
 //========================SERIALIZE/DESERIALIZE IMPLEMENTSTIONS===========================
 
+template <typename T, BufferWriter Writer>
+void serialize(const T& obj, Writer& w)
+{
+    serializer<T>::apply(obj, w);
+}
+
+template <typename T, BufferReader Reader>
+void deserialize(T& obj, Reader& r)
+{
+    deserializer<T>::apply(obj, r);
+}
+
 template <typename T>
 void serialize(const T& obj, std::ostream& os)
 {
-    serializer<T>::apply(obj, os);
+    StreamWriter w(os);
+    serialize(obj, w);
 }
 
 template <typename T>
 void deserialize(T& obj, std::istream& is)
 {
-    deserializer<T>::apply(obj, is);
+    StreamReader r(is);
+    deserialize(obj, r);
+}
+
+// Exact number of bytes that serialize() will write for the object with the given encoding
+template <typename Encoding, typename T>
+std::size_t serialized_size(const T& obj)
+{
+    return serializer<T>::template size<Encoding>(obj);
 }
\ No newline at end of file
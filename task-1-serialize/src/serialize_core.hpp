@@ -0,0 +1,501 @@
+#pragma once
+
+#include <iterator>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <memory>
+#include <utility>
+#include <string>
+#include <string_view>
+#include <span>
+
+#include "serialize_buffer.hpp"
+#include "serialize_encoding.hpp"
+#include "serialize_fields.hpp"
+
+/*
+The serialization core: how every kind of object is written, read and sized. The two front-ends
+(serialize_concepts.hpp and serialize_sfinae.hpp) only decide which kind an object is, with
+concepts or with SFINAE, and their serializer / deserializer specializations call these
+functions. So a faster path (bulk copies, varints, byte order, insertion hints) is written
+here once and both front-ends get it.
+
+The functions call serialize() / deserialize() / serialized_size() for the elements, so the
+dispatch of the front-end is used for them. The front-end includes this file after its
+declarations of serialize() and deserialize(). How a container is filled (reserve, insertion hints,
+moving the keys in) depends only on its member functions, the traits below find them.
+*/
+
+
+template <typename Encoding = FixedEncoding, typename T>
+std::size_t serialized_size(const T& obj);
+
+
+
+//=================================CONTAINER CAPABILITIES=================================
+
+template <typename ContainerType, typename = void>
+struct has_reserve : std::false_type{};
+
+template <typename ContainerType>
+struct has_reserve<ContainerType, std::void_t<decltype(std::declval<ContainerType>().reserve(std::declval<typename ContainerType::size_type>()))>>
+    : std::true_type{};
+
+
+// Sequential containers with emplace_back() that returns the new element get it constructed in place
+// (std::vector<bool> returns a proxy, it uses push_back)
+template <typename ContainerType, typename = void>
+struct has_emplace_back : std::false_type{};
+
+template <typename ContainerType>
+struct has_emplace_back<ContainerType, std::void_t<decltype(std::declval<ContainerType&>().emplace_back())>>
+    : std::is_same<decltype(std::declval<ContainerType&>().emplace_back()), typename ContainerType::value_type&>{};
+
+
+// Sorted containers get an insertion hint at the end: the elements were written in sorted order
+template <typename ContainerType, typename = void>
+struct is_sorted_associative : std::false_type{};
+
+template <typename ContainerType>
+struct is_sorted_associative<ContainerType, std::void_t<typename ContainerType::key_compare,
+    decltype(std::declval<ContainerType&>().emplace_hint(std::declval<ContainerType&>().end(), std::declval<typename ContainerType::value_type>()))>>
+    : std::true_type{};
+
+
+template <typename ContainerType, typename = void>
+struct is_sorted_map : std::false_type{};
+
+template <typename ContainerType>
+struct is_sorted_map<ContainerType, std::void_t<typename ContainerType::mapped_type,
+    decltype(std::declval<ContainerType&>().emplace_hint(std::declval<ContainerType&>().end(),
+        std::declval<typename ContainerType::key_type>(), std::declval<typename ContainerType::mapped_type>()))>>
+    : is_sorted_associative<ContainerType>{};
+
+
+// Hash containers get their buckets once before the insertions, so they are never rehashed
+template <typename ContainerType, typename = void>
+struct is_unordered_associative : std::false_type{};
+
+template <typename ContainerType>
+struct is_unordered_associative<ContainerType, std::void_t<typename ContainerType::hasher, typename ContainerType::key_equal>>
+    : has_reserve<ContainerType>{};
+
+
+template <typename ContainerType, typename = void>
+struct is_unordered_map : std::false_type{};
+
+template <typename ContainerType>
+struct is_unordered_map<ContainerType, std::void_t<typename ContainerType::mapped_type,
+    decltype(std::declval<ContainerType&>().emplace(std::declval<typename ContainerType::key_type>(), std::declval<typename ContainerType::mapped_type>()))>>
+    : is_unordered_associative<ContainerType>{};
+
+
+// Maps with unique keys (std::unordered_map) take the key and the value with try_emplace
+template <typename ContainerType, typename = void>
+struct is_unique_key_map : std::false_type{};
+
+template <typename ContainerType>
+struct is_unique_key_map<ContainerType, std::void_t<
+    decltype(std::declval<ContainerType&>().try_emplace(std::declval<typename ContainerType::key_type>(), std::declval<typename ContainerType::mapped_type>()))>>
+    : is_unordered_map<ContainerType>{};
+
+
+// Raw objects are written as one block, except integral values in the compact encoding
+template <typename T, typename Encoding>
+constexpr bool is_block_element = is_raw_serializable<T>::value && !(std::is_integral_v<T> && Encoding::varint);
+
+
+
+//=====================================BASE OBJECTS======================================
+
+template <typename T, typename Writer>
+void write_object(const T& obj, Writer& w)
+{
+    // The compact encoding writes integral values as varints
+    if constexpr (std::is_integral_v<T> && encoding_of_t<Writer>::varint)
+        write_integral(obj, w);
+    // Numbers are written in the byte order of the encoding, other objects as their raw bytes
+    else
+        write_value(obj, w);
+}
+
+template <typename T, typename Reader>
+void read_object(T& val, Reader& r)
+{
+    if constexpr (std::is_integral_v<T> && encoding_of_t<Reader>::varint)
+        read_integral(val, r);
+    else
+        read_value(val, r);
+}
+
+template <typename Encoding, typename T>
+std::size_t object_size(const T& obj)
+{
+    if constexpr (std::is_integral_v<T> && Encoding::varint)
+        return integral_size(obj);
+    else
+        return sizeof(T);
+}
+
+
+
+//========================================STRINGS========================================
+
+// std::string and std::string_view: the length, then the characters
+template <typename Writer>
+void write_chars(std::string_view str, Writer& w)
+{
+    const uint32_t len = static_cast<uint32_t>(str.size());
+    write_length(len, w);
+
+    if (len > 0)
+        w.write(reinterpret_cast<const std::byte*>(str.data()), len);
+}
+
+template <typename Encoding>
+std::size_t chars_size(std::string_view str)
+{
+    return length_size<Encoding>(static_cast<uint32_t>(str.size())) + str.size();
+}
+
+template <typename Reader>
+void read_string(std::string& str, Reader& r)
+{
+    uint32_t len = read_length(r);
+
+    // The string grows only as far as the input backs its length, in one step for a valid one
+    str.clear();
+    while (str.size() < len && !reader_failed(r))
+    {
+        const std::size_t offset = str.size();
+        const std::size_t step = std::max<std::size_t>(trusted_count<char>(r, len - offset), 1);
+        str.resize(offset + step);
+        r.read(reinterpret_cast<std::byte*>(str.data()) + offset, step);
+    }
+}
+
+// Points to the characters inside the buffer of the reader
+template <typename Reader>
+void read_string_view(std::string_view& str, Reader& r)
+{
+    uint32_t len = read_length(r);
+    str = std::string_view(reinterpret_cast<const char*>(r.view(len)), len);
+}
+
+
+
+//====================================BLOCKS OF OBJECTS====================================
+
+// The elements of a contiguous container of raw objects: one call for all of them
+template <typename T, typename Writer>
+void write_block(const T* data, uint32_t len, Writer& w)
+{
+    write_length(len, w);
+
+    if constexpr (!is_block_element<T, encoding_of_t<Writer>>)
+    {
+        for (uint32_t i = 0; i < len; ++i)
+            serialize(data[i], w);
+    }
+    else if (len > 0)
+    {
+        write_block_padding<T>(w);
+        write_raw_block(data, len, w);
+    }
+}
+
+template <typename Encoding, typename T>
+std::size_t block_size(const T* data, uint32_t len)
+{
+    if constexpr (!is_block_element<T, Encoding>)
+    {
+        std::size_t result = length_size<Encoding>(len);
+        for (uint32_t i = 0; i < len; ++i)
+            result += integral_size(data[i]);
+        return result;
+    }
+    else if (len > 0)
+        return length_size<Encoding>(len) + max_block_padding<T, Encoding>() + len * sizeof(T);
+    else
+        return length_size<Encoding>(len);
+}
+
+// Resizes the container and reads the block straight into it. A valid length takes one resize,
+// a length that the input can't back is reached in steps of trusted_count()
+template <typename ContainerType, typename Reader>
+void read_block(ContainerType& c, Reader& r)
+{
+    using value_type = typename ContainerType::value_type;
+    constexpr bool raw = is_block_element<value_type, encoding_of_t<Reader>>;
+
+    c.clear();
+
+    uint32_t len = read_length(r);
+    if (len == 0) return;
+
+    if constexpr (raw)
+        skip_block_padding<value_type>(r);
+
+    while (c.size() < len && !reader_failed(r))
+    {
+        const std::size_t offset = c.size();
+        const std::size_t step = std::max<std::size_t>(trusted_count<value_type>(r, len - offset, raw ? sizeof(value_type) : 1), 1);
+        c.resize(offset + step);
+
+        if constexpr (raw)
+            read_raw_block(std::to_address(c.begin()) + offset, step, r);
+        else
+        {
+            for (auto it = c.begin() + offset; it != c.end(); ++it)
+                deserialize(*it, r);
+        }
+    }
+}
+
+template <typename T, typename Reader>
+void read_span(std::span<const T>& span, Reader& r)
+{
+    static_assert(!(std::is_integral_v<T> && encoding_of_t<Reader>::varint), "Spans of integral values can't use the compact encoding");
+    static_assert(!needs_byte_swap<T, encoding_of_t<Reader>>, "Spans can't point to values stored with another byte order");
+
+    uint32_t len = read_length(r);
+
+    if (len == 0)
+    {
+        span = std::span<const T>();
+        return;
+    }
+
+    skip_block_padding<T>(r);
+    const std::byte* data_ptr = r.view(len * sizeof(T));
+    if (reinterpret_cast<std::uintptr_t>(data_ptr) % alignof(T) != 0)
+        throw SerializeBufferError("Cannot make a view: the block is not aligned. Serialize it with AlignedEncoding.");
+
+    span = std::span<const T>(reinterpret_cast<const T*>(data_ptr), len);
+}
+
+
+
+//=========================================VIEWS==========================================
+
+/*
+The serializers of std::string_view and std::span<const T>. Both front-ends specialize
+serializer with them, so the views have one format: a string_view is written like std::string,
+a span like std::vector<T>. The span of integral values can't be written with the compact
+encoding, because read_span() couldn't point to such values.
+*/
+struct string_view_serializer
+{
+    template <typename Writer>
+    static void apply(const std::string_view& str, Writer& w)
+    {
+        write_chars(str, w);
+    }
+
+    template <typename Encoding>
+    static std::size_t size(const std::string_view& str)
+    {
+        return chars_size<Encoding>(str);
+    }
+};
+
+template <typename T>
+struct span_serializer
+{
+    template <typename Writer>
+    static void apply(const std::span<const T>& span, Writer& w)
+    {
+        static_assert(!(std::is_integral_v<T> && encoding_of_t<Writer>::varint), "Spans of integral values can't use the compact encoding");
+
+        write_block(span.data(), static_cast<uint32_t>(span.size()), w);
+    }
+
+    template <typename Encoding>
+    static std::size_t size(const std::span<const T>& span)
+    {
+        return block_size<Encoding>(span.data(), static_cast<uint32_t>(span.size()));
+    }
+};
+
+
+
+//====================================PAIRS AND STRUCTS====================================
+
+template <typename T1, typename T2, typename Writer>
+void write_pair(const std::pair<T1, T2>& pair, Writer& w)
+{
+    serialize(pair.first, w);
+    serialize(pair.second, w);
+}
+
+template <typename Encoding, typename T1, typename T2>
+std::size_t pair_size(const std::pair<T1, T2>& pair)
+{
+    return serialized_size<Encoding>(pair.first) + serialized_size<Encoding>(pair.second);
+}
+
+// The key of a pair inside a map is const, it is read separately and moved in
+template <typename T1, typename T2, typename Reader>
+void read_pair(std::pair<const T1, T2>& pair, Reader& r)
+{
+    T1 volatile_key{};
+    deserialize(volatile_key, r);
+    T1* pair_first_ptr = const_cast<T1*>(&(pair.first));
+    *pair_first_ptr = std::move(volatile_key);
+    deserialize(pair.second, r);
+}
+
+
+// Structs listed with SERIALIZE_FIELDS, runs of adjacent raw fields are copied with one call
+template <typename T, typename Writer>
+void write_fields(const T& obj, Writer& w)
+{
+    const std::byte* bytes = reinterpret_cast<const std::byte*>(&obj);
+    visit_fields<T, encoding_of_t<Writer>>(
+        [&](std::size_t offset, std::size_t size) { w.write(bytes + offset, size); },
+        [&](auto member) { serialize(obj.*member, w); });
+}
+
+template <typename Encoding, typename T>
+std::size_t fields_size(const T& obj)
+{
+    std::size_t result = 0;
+    visit_fields<T, Encoding>(
+        [&](std::size_t, std::size_t size) { result += size; },
+        [&](auto member) { result += serialized_size<Encoding>(obj.*member); });
+    return result;
+}
+
+template <typename T, typename Reader>
+void read_fields(T& obj, Reader& r)
+{
+    std::byte* bytes = reinterpret_cast<std::byte*>(&obj);
+    visit_fields<T, encoding_of_t<Reader>>(
+        [&](std::size_t offset, std::size_t size) { r.read(bytes + offset, size); },
+        [&](auto member) { deserialize(obj.*member, r); });
+}
+
+
+
+//======================================CONTAINERS=======================================
+
+// Any container: the length, then the elements one by one
+template <typename ContainerType, typename Writer>
+void write_elements(const ContainerType& c, uint32_t len, Writer& w)
+{
+    write_length(len, w);
+
+    for (const auto& obj : c)
+        serialize(obj, w);
+}
+
+template <typename Encoding, typename ContainerType>
+std::size_t elements_size(const ContainerType& c, uint32_t len)
+{
+    using value_type = typename ContainerType::value_type;
+
+    // Objects that are written as raw bytes all have the same size
+    if constexpr (is_block_element<value_type, Encoding>)
+        return length_size<Encoding>(len) + len * sizeof(value_type);
+
+    std::size_t result = length_size<Encoding>(len);
+    for (const auto& obj : c)
+        result += serialized_size<Encoding>(obj);
+    return result;
+}
+
+
+// Containers with push_back, the elements are read in place when possible. Contiguous containers of raw objects were written as one block that may be padded
+template <bool ContiguousBlock, typename ContainerType, typename Reader>
+void read_sequential(ContainerType& c, Reader& r)
+{
+    using value_type = typename ContainerType::value_type;
+
+    c.clear();
+
+    uint32_t len = read_length(r);
+
+    if constexpr (has_reserve<ContainerType>::value)
+        c.reserve(trusted_count<value_type>(r, len));
+
+    if constexpr (ContiguousBlock && is_block_element<value_type, encoding_of_t<Reader>>)
+    {
+        if (len > 0) skip_block_padding<value_type>(r);
+    }
+
+    for (uint32_t i = 0; i < len; i++)
+    {
+        if constexpr (has_emplace_back<ContainerType>::value)
+            deserialize(c.emplace_back(), r);
+        else
+        {
+            value_type obj{};
+            deserialize(obj, r);
+            c.push_back(std::move(obj));
+        }
+    }
+}
+
+
+// Containers with insert. Keys of maps are read separately, so they are moved in and not copied from a const pair
+template <typename ContainerType, typename Reader>
+void read_associative(ContainerType& c, Reader& r)
+{
+    c.clear();
+
+    uint32_t len = read_length(r);
+
+    if constexpr (is_unordered_associative<ContainerType>::value)
+        c.reserve(trusted_count<typename ContainerType::value_type>(r, len));
+
+    for (uint32_t i = 0; i < len; i++)
+    {
+        if constexpr (is_sorted_map<ContainerType>::value)
+        {
+            typename ContainerType::key_type key{};
+            typename ContainerType::mapped_type value{};
+            deserialize(key, r);
+            deserialize(value, r);
+            c.emplace_hint(c.end(), std::move(key), std::move(value));
+        }
+        else if constexpr (is_unordered_map<ContainerType>::value)
+        {
+            typename ContainerType::key_type key{};
+            typename ContainerType::mapped_type value{};
+            deserialize(key, r);
+            deserialize(value, r);
+            if constexpr (is_unique_key_map<ContainerType>::value)
+                c.try_emplace(std::move(key), std::move(value));
+            else
+                c.emplace(std::move(key), std::move(value));
+        }
+        else
+        {
+            typename ContainerType::value_type obj{};
+            deserialize(obj, r);
+            if constexpr (is_sorted_associative<ContainerType>::value)
+                c.emplace_hint(c.end(), std::move(obj));
+            else
+                c.insert(std::move(obj));
+        }
+    }
+}
+
+
+// Containers with insert_after (std::forward_list): every element goes after the previous one
+template <typename ContainerType, typename Reader>
+void read_forward_list(ContainerType& c, Reader& r)
+{
+    c.clear();
+
+    uint32_t len = read_length(r);
+
+    auto it = c.before_begin();
+    for (uint32_t i = 0; i < len; i++)
+    {
+        typename ContainerType::value_type obj{};
+        deserialize(obj, r);
+        it = c.insert_after(it, std::move(obj));
+    }
+}
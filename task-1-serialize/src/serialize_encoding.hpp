@@ -0,0 +1,402 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <bit>
+#include <type_traits>
+#include <string>
+
+#include "serialize_buffer.hpp"
+#include "byte_swap.hpp"
+
+/*
+The encoding is a policy that tells serializers how lengths and integral values are written.
+
+FixedEncoding is the default: every length is a uint32_t and every integral value is written
+with its full width, exactly as the base serializer writes any other object.
+
+VarintEncoding is a compact format for data with many small numbers: lengths and integral
+values are written as LEB128 varints (7 bits per byte, the high bit means "more bytes follow"),
+signed values are zigzag-mapped first (0, -1, 1, -2, ... -> 0, 1, 2, 3, ...) so that small
+negative numbers are short too. Floating point values and other objects are written as before.
+
+AlignedEncoding is FixedEncoding plus zero padding before every block of raw objects (the
+elements of a std::vector<double>, for example), so that the block starts at a multiple of
+alignof(T) from the beginning of the buffer. This lets std::span<const T> views point straight
+into the buffer. The writer and the reader must have position(). serialized_size() is an upper
+bound for this encoding, because the padding depends on where the object is written.
+
+All of them write numbers in the byte order of the host. LittleEndianEncoding is FixedEncoding
+with a canonical byte order: lengths and integral, floating point and enum values (alone, in
+containers and in SERIALIZE_FIELDS structs) are little-endian on every host, so the data can be
+moved between hosts. On little-endian hosts it writes the same bytes as FixedEncoding at the same
+speed, elsewhere blocks of values are byte swapped with SIMD (see byte_swap.hpp). BigEndianEncoding
+is the same with the network byte order. Other trivially copyable structs are still written as
+their raw bytes, and std::span<const T> views of swapped values can't be read.
+
+A writer or a reader selects the encoding with a nested type `encoding`. Writers without it use
+FixedEncoding. Any writer/reader can be switched to another encoding with EncodedWriter /
+EncodedReader:
+
+    std::vector<std::byte> buffer;
+    VectorWriter inner(buffer);
+    auto w = with_encoding<VarintEncoding>(inner);
+    serialize(obj, w);
+*/
+
+
+struct FixedEncoding
+{
+    static constexpr bool varint = false;
+    static constexpr bool aligned_blocks = false;
+    static constexpr std::endian byte_order = std::endian::native;
+};
+
+struct VarintEncoding
+{
+    static constexpr bool varint = true;
+    static constexpr bool aligned_blocks = false;
+    static constexpr std::endian byte_order = std::endian::native;
+};
+
+struct AlignedEncoding
+{
+    static constexpr bool varint = false;
+    static constexpr bool aligned_blocks = true;
+    static constexpr std::endian byte_order = std::endian::native;
+};
+
+struct LittleEndianEncoding
+{
+    static constexpr bool varint = false;
+    static constexpr bool aligned_blocks = false;
+    static constexpr std::endian byte_order = std::endian::little;
+};
+
+struct BigEndianEncoding
+{
+    static constexpr bool varint = false;
+    static constexpr bool aligned_blocks = false;
+    static constexpr std::endian byte_order = std::endian::big;
+};
+
+
+// Values of type T are stored with the reversed byte order of the host
+template <typename T, typename Encoding>
+constexpr bool needs_byte_swap = is_byte_order_scalar<T> && Encoding::byte_order != std::endian::native;
+
+
+
+template <typename Stream, typename = void>
+struct encoding_of
+{
+    using type = FixedEncoding;
+};
+
+template <typename Stream>
+struct encoding_of<Stream, std::void_t<typename Stream::encoding>>
+{
+    using type = typename Stream::encoding;
+};
+
+template <typename Stream>
+using encoding_of_t = typename encoding_of<Stream>::type;
+
+
+
+//===================================ENCODING ADAPTERS===================================
+
+template <typename Encoding, typename Writer>
+class EncodedWriter
+{
+public:
+    using encoding = Encoding;
+
+    explicit EncodedWriter(Writer& writer) : m_writer(writer) {}
+
+    void write(const std::byte* data, std::size_t size) { m_writer.write(data, size); }
+
+    // Only when the wrapped writer has it
+    template <typename W = Writer>
+    auto extend(std::size_t size) -> decltype(std::declval<W&>().extend(size)) { return m_writer.extend(size); }
+
+    std::size_t position() const { return m_writer.position(); }
+
+private:
+    Writer& m_writer;
+};
+
+
+template <typename Encoding, typename Reader>
+class EncodedReader
+{
+public:
+    using encoding = Encoding;
+
+    explicit EncodedReader(Reader& reader) : m_reader(reader) {}
+
+    void read(std::byte* data, std::size_t size) { m_reader.read(data, size); }
+
+    // Only when the wrapped reader has them
+    template <typename R = Reader>
+    auto view(std::size_t size) -> decltype(std::declval<R&>().view(size)) { return m_reader.view(size); }
+
+    template <typename R = Reader>
+    auto remaining() const -> decltype(std::declval<const R&>().remaining()) { return m_reader.remaining(); }
+
+    template <typename R = Reader>
+    auto failed() const -> decltype(std::declval<const R&>().failed()) { return m_reader.failed(); }
+
+    std::size_t position() const { return m_reader.position(); }
+
+private:
+    Reader& m_reader;
+};
+
+
+template <typename Encoding, typename Writer>
+EncodedWriter<Encoding, Writer> with_encoding(Writer& w)
+{
+    return EncodedWriter<Encoding, Writer>(w);
+}
+
+template <typename Encoding, typename Reader>
+EncodedReader<Encoding, Reader> with_decoding(Reader& r)
+{
+    return EncodedReader<Encoding, Reader>(r);
+}
+
+
+
+//========================================VARINTS========================================
+
+constexpr std::size_t MAX_VARINT_SIZE = 10;
+
+
+inline uint64_t zigzag_encode(int64_t value)
+{
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+inline int64_t zigzag_decode(uint64_t value)
+{
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+
+inline std::size_t varint_size(uint64_t value)
+{
+    std::size_t size = 1;
+    while (value >= 0x80)
+    {
+        value >>= 7;
+        ++size;
+    }
+    return size;
+}
+
+
+template <typename Writer>
+void write_varint(uint64_t value, Writer& w)
+{
+    // Encode into a small local buffer so the writer gets one call per number
+    std::byte bytes[MAX_VARINT_SIZE];
+    std::size_t size = 0;
+    while (value >= 0x80)
+    {
+        bytes[size++] = static_cast<std::byte>((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    bytes[size++] = static_cast<std::byte>(value);
+
+    w.write(bytes, size);
+}
+
+
+template <typename Reader>
+uint64_t read_varint(Reader& r)
+{
+    uint64_t value = 0;
+    for (std::size_t i = 0; i < MAX_VARINT_SIZE; ++i)
+    {
+        std::byte byte{};
+        r.read(&byte, 1);
+
+        const uint64_t bits = std::to_integer<uint64_t>(byte);
+        // The 10th byte holds only the 64th bit, anything else would be dropped
+        if (i == MAX_VARINT_SIZE - 1 && bits > 1)
+            throw SerializeBufferError("Invalid varint: the value doesn't fit into 64 bits.");
+        value |= (bits & 0x7F) << (7 * i);
+        if ((bits & 0x80) == 0) return value;
+    }
+
+    throw SerializeBufferError("Invalid varint: more than " + std::to_string(MAX_VARINT_SIZE) + " bytes.");
+}
+
+
+
+//======================================BYTE ORDER=======================================
+
+// Raw bytes of a trivially copyable value, numbers in the byte order of the encoding
+template <typename T, typename Writer>
+void write_value(const T& value, Writer& w)
+{
+    if constexpr (needs_byte_swap<T, encoding_of_t<Writer>>)
+    {
+        const T swapped = byte_swap_value(value);
+        w.write(reinterpret_cast<const std::byte*>(&swapped), sizeof(T));
+    }
+    else
+        w.write(reinterpret_cast<const std::byte*>(&value), sizeof(T));
+}
+
+template <typename T, typename Reader>
+void read_value(T& value, Reader& r)
+{
+    r.read(reinterpret_cast<std::byte*>(&value), sizeof(T));
+    if constexpr (needs_byte_swap<T, encoding_of_t<Reader>>)
+        value = byte_swap_value(value);
+}
+
+
+constexpr std::size_t BYTE_SWAP_CHUNK_SIZE = 4096;
+
+// A block of count trivially copyable values, written with one call when no byte swapping is needed
+template <typename T, typename Writer>
+void write_raw_block(const T* data, std::size_t count, Writer& w)
+{
+    if constexpr (needs_byte_swap<T, encoding_of_t<Writer>>)
+    {
+        // The source is const, so the values are swapped through a small buffer
+        constexpr std::size_t chunk_count = BYTE_SWAP_CHUNK_SIZE / sizeof(T);
+        T chunk[chunk_count];
+        while (count > 0)
+        {
+            const std::size_t n = std::min(count, chunk_count);
+            byte_swap_copy(data, chunk, n);
+            w.write(reinterpret_cast<const std::byte*>(chunk), n * sizeof(T));
+            data += n;
+            count -= n;
+        }
+    }
+    else
+        w.write(reinterpret_cast<const std::byte*>(data), count * sizeof(T));
+}
+
+template <typename T, typename Reader>
+void read_raw_block(T* data, std::size_t count, Reader& r)
+{
+    r.read(reinterpret_cast<std::byte*>(data), count * sizeof(T));
+    if constexpr (needs_byte_swap<T, encoding_of_t<Reader>>)
+        byte_swap_block(data, count);
+}
+
+
+
+//===============================LENGTHS AND INTEGRAL VALUES===============================
+
+template <typename Writer>
+void write_length(uint32_t len, Writer& w)
+{
+    if constexpr (encoding_of_t<Writer>::varint)
+        write_varint(len, w);
+    else
+        write_value(len, w);
+}
+
+template <typename Reader>
+uint32_t read_length(Reader& r)
+{
+    if constexpr (encoding_of_t<Reader>::varint)
+    {
+        const uint64_t len = read_varint(r);
+        if (len > UINT32_MAX) throw SerializeBufferError("Invalid length: " + std::to_string(len) + " doesn't fit into 32 bits.");
+        return static_cast<uint32_t>(len);
+    }
+    else
+    {
+        uint32_t len = 0;
+        read_value(len, r);
+        return len;
+    }
+}
+
+template <typename Encoding>
+std::size_t length_size(uint32_t len)
+{
+    if constexpr (Encoding::varint)
+        return varint_size(len);
+    else
+        return sizeof(uint32_t);
+}
+
+
+// Varint writing of an integral value, signed values are zigzag-mapped
+template <typename T, typename Writer>
+void write_integral(T value, Writer& w)
+{
+    if constexpr (std::is_signed_v<T>)
+        write_varint(zigzag_encode(static_cast<int64_t>(value)), w);
+    else
+        write_varint(static_cast<uint64_t>(value), w);
+}
+
+template <typename T, typename Reader>
+void read_integral(T& value, Reader& r)
+{
+    if constexpr (std::is_signed_v<T>)
+        value = static_cast<T>(zigzag_decode(read_varint(r)));
+    else
+        value = static_cast<T>(read_varint(r));
+}
+
+template <typename T>
+std::size_t integral_size(T value)
+{
+    if constexpr (std::is_signed_v<T>)
+        return varint_size(zigzag_encode(static_cast<int64_t>(value)));
+    else
+        return varint_size(static_cast<uint64_t>(value));
+}
+
+
+
+//=====================================BLOCK PADDING=====================================
+
+template <typename T>
+std::size_t block_padding(std::size_t position)
+{
+    return (alignof(T) - position % alignof(T)) % alignof(T);
+}
+
+// Padding before a block of raw objects of type T, written only by the aligned encoding
+template <typename T, typename Writer>
+void write_block_padding(Writer& w)
+{
+    if constexpr (encoding_of_t<Writer>::aligned_blocks)
+    {
+        const std::byte zeros[alignof(T)] = {};
+        w.write(zeros, block_padding<T>(w.position()));
+    }
+}
+
+template <typename T, typename Reader>
+void skip_block_padding(Reader& r)
+{
+    if constexpr (encoding_of_t<Reader>::aligned_blocks)
+    {
+        std::byte skipped[alignof(T)];
+        r.read(skipped, block_padding<T>(r.position()));
+    }
+}
+
+template <typename T, typename Encoding>
+std::size_t max_block_padding()
+{
+    if constexpr (Encoding::aligned_blocks)
+        return alignof(T) - 1;
+    else
+        return 0;
+}
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+#include <string_view>
+#include <span>
+#include <type_traits>
+
+#include "serialize_encoding.hpp"
+
+/*
+Field lists for user structs. The base serializer writes the raw bytes of an object, which is
+wrong for structs with std::string / containers inside and wastes space on padding. A struct
+listed with SERIALIZE_FIELDS is serialized field by field instead:
+
+    struct Person
+    {
+        std::string name;
+        int age;
+        double height;
+        std::vector<int> scores;
+    };
+    SERIALIZE_FIELDS(Person, name, age, height, scores)
+
+The fields are written in the order of the list, every one in its own format. Runs of adjacent
+trivially copyable fields (`age` and `height` above if there is no padding between them) are
+written and read with one call, padding bytes are never written. The list is known at compile
+time, so the runs are found at compile time too.
+
+SERIALIZE_FIELDS must be used in the global namespace, after the struct is complete.
+*/
+
+
+// Position and type of one listed field
+template <typename Class, typename Field>
+struct field_info
+{
+    using type = Field;
+
+    Field Class::* member;
+    std::size_t offset;
+};
+
+
+// Specialized by SERIALIZE_FIELDS with a tuple of field_info
+template <typename T>
+struct serialize_fields;
+
+
+template <typename T, typename = void>
+struct has_serialize_fields : std::false_type{};
+
+template <typename T>
+struct has_serialize_fields<T, std::void_t<decltype(serialize_fields<T>::fields)>> : std::true_type{};
+
+
+
+/*
+Objects that are serialized as their raw bytes by the base serializer. std::pair, views and
+listed structs are trivially copyable too, but they have their own serializers.
+*/
+template <typename T>
+struct is_raw_serializable : std::bool_constant<std::is_trivially_copyable_v<T> && !has_serialize_fields<T>::value>{};
+
+template <typename T1, typename T2>
+struct is_raw_serializable<std::pair<T1, T2>> : std::false_type{};
+
+template <>
+struct is_raw_serializable<std::string_view> : std::false_type{};
+
+template <typename T, std::size_t Extent>
+struct is_raw_serializable<std::span<T, Extent>> : std::false_type{};
+
+
+
+// A field that is written as raw bytes with the encoding (integral values are varints in the compact encoding,
+// numbers are written one by one when their byte order is swapped)
+template <typename Field, typename Encoding>
+constexpr bool is_raw_field = is_raw_serializable<Field>::value && !(std::is_integral_v<Field> && Encoding::varint)
+    && !needs_byte_swap<Field, Encoding>;
+
+
+template <typename T>
+constexpr std::size_t field_count = std::tuple_size_v<std::remove_const_t<decltype(serialize_fields<T>::fields)>>;
+
+template <typename T, std::size_t I>
+using field_type_t = typename std::tuple_element_t<I, std::remove_const_t<decltype(serialize_fields<T>::fields)>>::type;
+
+
+// End (exclusive) of the run of adjacent raw fields that starts at field I, I if the field is not raw
+template <typename T, typename Encoding, std::size_t I>
+constexpr std::size_t raw_run_end()
+{
+    if constexpr (I >= field_count<T>)
+        return I;
+    else if constexpr (!is_raw_field<field_type_t<T, I>, Encoding>)
+        return I;
+    else if constexpr (I + 1 >= field_count<T>)
+        return I + 1;
+    else
+    {
+        // The next field joins the run if it is raw too and there is no padding before it
+        constexpr auto& fields = serialize_fields<T>::fields;
+        if constexpr (is_raw_field<field_type_t<T, I + 1>, Encoding>
+                      && std::get<I>(fields).offset + sizeof(field_type_t<T, I>) == std::get<I + 1>(fields).offset)
+            return raw_run_end<T, Encoding, I + 1>();
+        else
+            return I + 1;
+    }
+}
+
+
+/*
+Walks the fields of T: calls raw_run(offset, size) for every run of adjacent raw fields and
+field(member_pointer) for every other field. The serializers only decide what to do with them.
+*/
+template <typename T, typename Encoding, std::size_t I = 0, typename RawRun, typename Field>
+void visit_fields(RawRun&& raw_run, Field&& field)
+{
+    if constexpr (I < field_count<T>)
+    {
+        constexpr auto& fields = serialize_fields<T>::fields;
+        constexpr std::size_t end = raw_run_end<T, Encoding, I>();
+
+        if constexpr (end > I)
+        {
+            constexpr std::size_t first = std::get<I>(fields).offset;
+            constexpr std::size_t last = std::get<end - 1>(fields).offset + sizeof(field_type_t<T, end - 1>);
+            raw_run(first, last - first);
+            visit_fields<T, Encoding, end>(raw_run, field);
+        }
+        else
+        {
+            field(std::get<I>(fields).member);
+            visit_fields<T, Encoding, I + 1>(raw_run, field);
+        }
+    }
+}
+
+
+
+//=========================================MACRO=========================================
+
+#define SERIALIZE_FIELDS_PARENS ()
+
+#define SERIALIZE_FIELDS_EXPAND(...) SERIALIZE_FIELDS_EXPAND3(SERIALIZE_FIELDS_EXPAND3(SERIALIZE_FIELDS_EXPAND3(SERIALIZE_FIELDS_EXPAND3(__VA_ARGS__))))
+#define SERIALIZE_FIELDS_EXPAND3(...) SERIALIZE_FIELDS_EXPAND2(SERIALIZE_FIELDS_EXPAND2(SERIALIZE_FIELDS_EXPAND2(SERIALIZE_FIELDS_EXPAND2(__VA_ARGS__))))
+#define SERIALIZE_FIELDS_EXPAND2(...) SERIALIZE_FIELDS_EXPAND1(SERIALIZE_FIELDS_EXPAND1(SERIALIZE_FIELDS_EXPAND1(SERIALIZE_FIELDS_EXPAND1(__VA_ARGS__))))
+#define SERIALIZE_FIELDS_EXPAND1(...) __VA_ARGS__
+
+#define SERIALIZE_FIELDS_INFO(Type, field) field_info<Type, decltype(Type::field)>{&Type::field, offsetof(Type, field)}
+
+#define SERIALIZE_FIELDS_FOR_EACH(Type, ...) __VA_OPT__(SERIALIZE_FIELDS_EXPAND(SERIALIZE_FIELDS_FOR_EACH_HELPER(Type, __VA_ARGS__)))
+#define SERIALIZE_FIELDS_FOR_EACH_HELPER(Type, field, ...) \
+    SERIALIZE_FIELDS_INFO(Type, field) __VA_OPT__(, SERIALIZE_FIELDS_FOR_EACH_AGAIN SERIALIZE_FIELDS_PARENS (Type, __VA_ARGS__))
+#define SERIALIZE_FIELDS_FOR_EACH_AGAIN() SERIALIZE_FIELDS_FOR_EACH_HELPER
+
+// offsetof is conditionally supported for types that are not standard-layout (structs with std::string inside),
+// GCC, Clang and MSVC support it for types without virtual bases
+#define SERIALIZE_FIELDS(Type, ...)                                                         \
+    _Pragma("GCC diagnostic push")                                                         \
+    _Pragma("GCC diagnostic ignored \"-Winvalid-offsetof\"")                               \
+    template <>                                                                            \
+    struct serialize_fields<Type>                                                          \
+    {                                                                                      \
+        static constexpr auto fields = std::make_tuple(SERIALIZE_FIELDS_FOR_EACH(Type, __VA_ARGS__)); \
+    };                                                                                     \
+    _Pragma("GCC diagnostic pop")
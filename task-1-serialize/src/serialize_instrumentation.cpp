@@ -0,0 +1,69 @@
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <atomic>
+
+#include "serialize_instrumentation.hpp"
+
+
+namespace
+{
+    std::atomic<std::size_t> g_allocations{0};
+    std::atomic<std::size_t> g_allocated_bytes{0};
+    std::atomic<std::size_t> g_bytes_copied{0};
+    std::atomic<std::size_t> g_stream_calls{0};
+
+    void* counted_allocation(std::size_t size, std::size_t alignment)
+    {
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+        g_allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+
+        if (size == 0) size = 1;
+        while (true)
+        {
+            void* ptr = nullptr;
+            if (alignment <= alignof(std::max_align_t))
+                ptr = std::malloc(size);
+            else
+                ptr = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+            if (ptr != nullptr) return ptr;
+
+            // Like the standard operator new: the new_handler may free some memory and the allocation is tried again
+            std::new_handler handler = std::get_new_handler();
+            if (handler == nullptr) throw std::bad_alloc();
+            handler();
+        }
+    }
+}
+
+
+SerializeCounters serialize_counters_total()
+{
+    return {g_allocations.load(std::memory_order_relaxed), g_allocated_bytes.load(std::memory_order_relaxed),
+            g_bytes_copied.load(std::memory_order_relaxed), g_stream_calls.load(std::memory_order_relaxed)};
+}
+
+void count_stream_call(std::size_t bytes_copied)
+{
+    g_stream_calls.fetch_add(1, std::memory_order_relaxed);
+    g_bytes_copied.fetch_add(bytes_copied, std::memory_order_relaxed);
+}
+
+
+
+//============================REPLACED GLOBAL ALLOCATION FUNCTIONS============================
+// The nothrow forms call these ones by default, so they are counted too
+
+void* operator new(std::size_t size) { return counted_allocation(size, alignof(std::max_align_t)); }
+void* operator new[](std::size_t size) { return counted_allocation(size, alignof(std::max_align_t)); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return counted_allocation(size, static_cast<std::size_t>(alignment)); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return counted_allocation(size, static_cast<std::size_t>(alignment)); }
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { std::free(ptr); }
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <iostream>
+#include <cstddef>
+#include <type_traits>
+
+#include "serialize_buffer.hpp"
+#include "serialize_encoding.hpp"
+
+/*
+Opt-in instrumentation for finding out what one serialize() / deserialize() call costs:
+heap allocations, bytes copied through the writer / reader and the number of write() / read()
+calls (stream calls).
+
+    std::vector<std::vector<std::string>> obj;
+    SpanReader r(buffer);
+    SerializeCounters c = counted_deserialize(obj, r);
+    EXPECT_LE(c.allocations, expected);
+
+Allocations are counted by the global operator new replaced in serialize_instrumentation.cpp.
+It is not a part of serialize_core: a program opts in by linking the serialize_instrumentation
+library (serialize_core.cmake), the test targets and serialize_bench do.
+Bytes and calls are counted by InstrumentedWriter / InstrumentedReader, which wrap any writer
+or reader. view() of a reader is counted as a call, but not as copied bytes.
+
+The counters are global: allocations made by other threads during the scope (for example,
+by serialize_parallel()) are counted too.
+*/
+
+
+struct SerializeCounters
+{
+    std::size_t allocations = 0;
+    std::size_t allocated_bytes = 0;
+    std::size_t bytes_copied = 0;
+    std::size_t stream_calls = 0;
+};
+
+inline SerializeCounters operator-(const SerializeCounters& lhs, const SerializeCounters& rhs)
+{
+    return {lhs.allocations - rhs.allocations, lhs.allocated_bytes - rhs.allocated_bytes,
+            lhs.bytes_copied - rhs.bytes_copied, lhs.stream_calls - rhs.stream_calls};
+}
+
+
+// Totals since the start of the program (defined in serialize_instrumentation.cpp)
+SerializeCounters serialize_counters_total();
+
+// Called by the instrumented writers and readers
+void count_stream_call(std::size_t bytes_copied);
+
+
+// Counts everything that happens between its construction and the call of counters()
+class ScopedSerializeCounters
+{
+public:
+    ScopedSerializeCounters() : m_start(serialize_counters_total()) {}
+
+    SerializeCounters counters() const { return serialize_counters_total() - m_start; }
+
+private:
+    SerializeCounters m_start;
+};
+
+
+
+//==================================INSTRUMENTED STREAMS=================================
+
+template <typename Writer>
+class InstrumentedWriter
+{
+public:
+    using encoding = encoding_of_t<Writer>;
+
+    explicit InstrumentedWriter(Writer& writer) : m_writer(writer) {}
+
+    void write(const std::byte* data, std::size_t size)
+    {
+        count_stream_call(size);
+        m_writer.write(data, size);
+    }
+
+    std::size_t position() const { return m_writer.position(); }
+
+private:
+    Writer& m_writer;
+};
+
+
+template <typename Reader>
+class InstrumentedReader
+{
+public:
+    using encoding = encoding_of_t<Reader>;
+
+    explicit InstrumentedReader(Reader& reader) : m_reader(reader) {}
+
+    void read(std::byte* data, std::size_t size)
+    {
+        count_stream_call(size);
+        m_reader.read(data, size);
+    }
+
+    const std::byte* view(std::size_t size)
+    {
+        count_stream_call(0);
+        return m_reader.view(size);
+    }
+
+    std::size_t position() const { return m_reader.position(); }
+
+private:
+    Reader& m_reader;
+};
+
+
+
+// serialize() through an instrumented writer, returns what the call cost. Works with std::ostream too
+template <typename T, typename Writer>
+SerializeCounters counted_serialize(const T& obj, Writer& w)
+{
+    if constexpr (std::is_base_of_v<std::ostream, Writer>)
+    {
+        StreamWriter stream_writer(w);
+        return counted_serialize(obj, stream_writer);
+    }
+    else
+    {
+        InstrumentedWriter<Writer> instrumented(w);
+        ScopedSerializeCounters scope;
+        serialize(obj, instrumented);
+        return scope.counters();
+    }
+}
+
+
+// deserialize() through an instrumented reader, returns what the call cost. Works with std::istream too
+template <typename T, typename Reader>
+SerializeCounters counted_deserialize(T& obj, Reader& r)
+{
+    if constexpr (std::is_base_of_v<std::istream, Reader>)
+    {
+        StreamReader stream_reader(r);
+        return counted_deserialize(obj, stream_reader);
+    }
+    else
+    {
+        InstrumentedReader<Reader> instrumented(r);
+        ScopedSerializeCounters scope;
+        deserialize(obj, instrumented);
+        return scope.counters();
+    }
+}
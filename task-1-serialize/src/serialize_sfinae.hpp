@@ -6,16 +6,51 @@
 #include <type_traits>
 #include <cstdint>
 #include <string>
+#include <string_view>
+#include <span>
 #include <utility>
+#include <memory>
 
+#include "serialize_buffer.hpp"
+#include "serialize_encoding.hpp"
+#include "serialize_fields.hpp"
 
 
+
+template <typename Writer, typename = void>
+struct is_buffer_writer : std::false_type{};
+
+template <typename Writer>
+struct is_buffer_writer<Writer, std::void_t<decltype(std::declval<Writer&>().write(std::declval<const std::byte*>(), std::declval<std::size_t>()))>>
+    : std::true_type{};
+
+
+
+template <typename Reader, typename = void>
+struct is_buffer_reader : std::false_type{};
+
+template <typename Reader>
+struct is_buffer_reader<Reader, std::void_t<decltype(std::declval<Reader&>().read(std::declval<std::byte*>(), std::declval<std::size_t>()))>>
+    : std::true_type{};
+
+
+
+template <typename T, typename Writer, std::enable_if_t<is_buffer_writer<Writer>::value, int> = 0>
+void serialize(const T& obj, Writer& w);
+
+template <typename T, typename Reader, std::enable_if_t<is_buffer_reader<Reader>::value, int> = 0>
+void deserialize(T& obj, Reader& r);
+
 template <typename T>
 void serialize(const T& obj, std::ostream& os);
 
 template <typename T>
 void deserialize(T& obj, std::istream& is);
 
+// The core calls serialize() / deserialize() for the elements, so it goes after their declarations
+#include "serialize_core.hpp"
+
+
 
 template <typename ContainerType, typename = void>
 struct has_begin_end : std::false_type{};
@@ -83,18 +118,83 @@ struct has_insert_after<ContainerType, std::void_t<decltype(std::declval<Contain
     : std::true_type{};
 
 
+template <typename ContainerType, typename = void>
+struct has_resize : std::false_type{};
+
+template <typename ContainerType>
+struct has_resize<ContainerType, std::void_t<decltype(std::declval<ContainerType>().resize(std::declval<typename ContainerType::size_type>()))>>
+    : std::true_type{};
+
+
+
+template <typename Iterator, typename = void>
+struct is_contiguous_iterator : std::is_pointer<Iterator>{};
+
+template <typename Iterator>
+struct is_contiguous_iterator<Iterator, std::void_t<typename Iterator::iterator_concept>>
+    : std::is_base_of<std::contiguous_iterator_tag, typename Iterator::iterator_concept>{};
+
+
+
+/*
+Trivially copyable objects are written by the base serializer as their raw bytes, so 
+a whole range of them can be written (and read back) with one call instead of a loop.
+std::pair, views and structs listed with SERIALIZE_FIELDS are trivially copyable too, 
+but they have their own serializers, so they are excluded (see is_raw_serializable).
+*/
+template <typename T>
+struct is_bitwise_serializable : is_raw_serializable<T>{};
+
+
+
+template <typename ContainerType, typename = void>
+struct is_contiguous_bitwise_container : std::false_type{};
+
+template <typename ContainerType>
+struct is_contiguous_bitwise_container<ContainerType, std::enable_if_t<has_size<ContainerType>::value && has_begin_end<ContainerType>::value 
+                                                                      && !std::is_same_v<ContainerType, std::string>>>
+    : std::bool_constant<is_contiguous_iterator<decltype(std::declval<const ContainerType&>().begin())>::value 
+                         && is_bitwise_serializable<typename ContainerType::value_type>::value>{};
+
+
+
+// Spans of raw objects have their own serializer (see the views below)
+template <typename ContainerType>
+struct is_bitwise_span : std::false_type{};
+
+template <typename T>
+struct is_bitwise_span<std::span<const T>> : is_bitwise_serializable<T>{};
+
+
+
+template <typename ContainerType, typename = void>
+struct is_resizable_bitwise_container : std::false_type{};
+
+template <typename ContainerType>
+struct is_resizable_bitwise_container<ContainerType, std::enable_if_t<has_clear<ContainerType>::value && has_push_back<ContainerType>::value>>
+    : std::bool_constant<is_contiguous_bitwise_container<ContainerType>::value && has_resize<ContainerType>::value>{};
+
+
+/*
+The specializations only choose the kind of the object, the work is done by the functions
+of serialize_core.hpp, which are shared with the concepts version.
+*/
+
 template <typename T, typename = void>
 struct serializer
 {
-    static void apply(const T& obj, std::ostream& os)
+    template <typename Writer>
+    static void apply(const T& obj, Writer& w)
     {
         // std::cout << "Using sfinae serializer" << std::endl;
 
-        const uint8_t* ptr = reinterpret_cast<const uint8_t *>(&obj);
-
-        std::ostream_iterator<uint8_t> oi(os);
+        write_object(obj, w);
+    }
 
-        std::copy(ptr, ptr + sizeof(T), oi);
+    template <typename Encoding>
+    static std::size_t size(const T& obj)
+    {
+        return object_size<Encoding>(obj);
     }
 };
 
@@ -102,15 +202,12 @@ struct serializer
 template <typename T, typename = void>
 struct deserializer
 {
-    static void apply(T& val, std::istream& is)
+    template <typename Reader>
+    static void apply(T& val, Reader& r)
     {
         // std::cout << "Using base deserializer" << std::endl;
 
-        uint8_t* ptr = reinterpret_cast<uint8_t*>(&val);
-
-        std::istream_iterator<uint8_t> ii(is);
-
-        std::copy_n(ii, sizeof(T), ptr);
+        read_object(val, r);
     }
 };
 
@@ -118,21 +215,18 @@ struct deserializer
 template <>
 struct serializer<std::string>
 {
-    static void apply(const std::string& str, std::ostream& os)
+    template <typename Writer>
+    static void apply(const std::string& str, Writer& w)
     {
         // std::cout << "Using string serializer" << std::endl;
 
-        // Write the len of the string
-        const uint32_t len = static_cast<uint32_t>(str.size());
-        serialize(len, os);
-
-        if (len > 0)
-        {
-            // Write the data of the string
-            std::ostream_iterator<uint8_t> oi(os, "");
-            const uint8_t* data_ptr = reinterpret_cast<const uint8_t*>(str.data());
-            std::copy(data_ptr, data_ptr + len, oi);
-        }
+        write_chars(str, w);
+    }
+
+    template <typename Encoding>
+    static std::size_t size(const std::string& str)
+    {
+        return chars_size<Encoding>(str);
     }
 };
 
@@ -140,22 +234,50 @@ struct serializer<std::string>
 template <>
 struct deserializer<std::string>
 {
-    static void apply(std::string& str, std::istream& is)
+    template <typename Reader>
+    static void apply(std::string& str, Reader& r)
     {
         // std::cout << "Using string deserializer" << std::endl;
 
-        // Read the len of the string
-        uint32_t len = 0;
-        deserialize(len, is);
-
-        if (len > 0)
-        {
-            // Read the characters
-            str.clear();
-            str.resize(len);
-            std::istream_iterator<char> ii(is);
-            std::copy_n(ii, static_cast<size_t>(len), str.data());
-        }
+        read_string(str, r);
+    }
+};
+
+
+
+/*
+Zero-copy views: std::string_view and std::span<const T> are written by the serializers of 
+serialize_core.hpp, which are shared with the concepts version, so they have the same format 
+as std::string and std::vector<T>. They are deserialized without copying: the view points 
+into the buffer of the reader, so the buffer must outlive the view and the reader must have view().
+*/
+template <>
+struct serializer<std::string_view> : string_view_serializer{};
+
+template <typename T>
+struct serializer<std::span<const T>, std::enable_if_t<is_bitwise_serializable<T>::value>> : span_serializer<T>{};
+
+template <>
+struct deserializer<std::string_view>
+{
+    template <typename Reader>
+    static void apply(std::string_view& str, Reader& r)
+    {
+        // std::cout << "Using string_view deserializer" << std::endl;
+
+        read_string_view(str, r);
+    }
+};
+
+template <typename T>
+struct deserializer<std::span<const T>, std::enable_if_t<is_bitwise_serializable<T>::value>>
+{
+    template <typename Reader>
+    static void apply(std::span<const T>& span, Reader& r)
+    {
+        // std::cout << "Using span deserializer" << std::endl;
+
+        read_span(span, r);
     }
 };
 
@@ -163,71 +285,134 @@ struct deserializer<std::string>
 template <typename T1, typename T2>
 struct serializer<std::pair<T1, T2>>
 {
-    static void apply(const std::pair<T1, T2>& pair, std::ostream& os)
+    template <typename Writer>
+    static void apply(const std::pair<T1, T2>& pair, Writer& w)
     {
         // std::cout << "Using pair serializer" << std::endl;
 
-        serialize(pair.first, os);
-        serialize(pair.second, os);
+        write_pair(pair, w);
+    }
+
+    template <typename Encoding>
+    static std::size_t size(const std::pair<T1, T2>& pair)
+    {
+        return pair_size<Encoding>(pair);
     }
 };
 
 template <typename T1, typename T2>
 struct deserializer<std::pair<const T1, T2>>
 {
-    static void apply(std::pair<const T1, T2>& pair, std::istream& is)
+    template <typename Reader>
+    static void apply(std::pair<const T1, T2>& pair, Reader& r)
     {
         // std::cout << "Using pair deserializer" << std::endl;
-        T1 volatile_key{};
-        deserialize(volatile_key, is);
-        T1* pair_first_ptr = const_cast<T1*>(&(pair.first));
-        *pair_first_ptr = volatile_key;
-        deserialize(pair.second, is);
+
+        read_pair(pair, r);
     }
 };
 
 
 
+// ===User structs listed with SERIALIZE_FIELDS===
+/*
+The fields are written one by one in the order of the list, runs of adjacent trivially
+copyable fields are copied with one call (see serialize_fields.hpp).
+*/
+template <typename T>
+struct serializer<T, std::enable_if_t<has_serialize_fields<T>::value>>
+{
+    template <typename Writer>
+    static void apply(const T& obj, Writer& w)
+    {
+        // std::cout << "Using serializer for listed fields" << std::endl;
+
+        write_fields(obj, w);
+    }
+
+    template <typename Encoding>
+    static std::size_t size(const T& obj)
+    {
+        return fields_size<Encoding>(obj);
+    }
+};
+
+template <typename T>
+struct deserializer<T, std::enable_if_t<has_serialize_fields<T>::value>>
+{
+    template <typename Reader>
+    static void apply(T& obj, Reader& r)
+    {
+        // std::cout << "Using deserializer for listed fields" << std::endl;
+
+        read_fields(obj, r);
+    }
+};
+
 
 
 template <typename ContainerType>
-struct serializer<ContainerType, std::enable_if_t<has_size<ContainerType>::value && has_begin_end<ContainerType>::value>>
+struct serializer<ContainerType, std::enable_if_t<has_size<ContainerType>::value && has_begin_end<ContainerType>::value 
+                                                 && !is_contiguous_bitwise_container<ContainerType>::value>>
 {
-    static void apply(const ContainerType& c, std::ostream& os)
+    template <typename Writer>
+    static void apply(const ContainerType& c, Writer& w)
     {
         // std::cout << "Using serializer for standart container" << std::endl;
 
-        // Write the len of the container
-        const uint32_t len = static_cast<uint32_t>(c.size());
-        serialize(len, os);
+        write_elements(c, static_cast<uint32_t>(c.size()), w);
+    }
+
+    template <typename Encoding>
+    static std::size_t size(const ContainerType& c)
+    {
+        return elements_size<Encoding>(c, static_cast<uint32_t>(c.size()));
+    }
+};
 
-        // Write objects
-        for (const auto& obj : c)
-            serialize(obj, os);
+
+template <typename ContainerType>
+struct serializer<ContainerType, std::enable_if_t<is_contiguous_bitwise_container<ContainerType>::value && !is_bitwise_span<ContainerType>::value>>
+{
+    template <typename Writer>
+    static void apply(const ContainerType& c, Writer& w)
+    {
+        // std::cout << "Using serializer for contiguous container" << std::endl;
+
+        write_block(std::to_address(c.begin()), static_cast<uint32_t>(c.size()), w);
+    }
+
+    template <typename Encoding>
+    static std::size_t size(const ContainerType& c)
+    {
+        return block_size<Encoding>(std::to_address(c.begin()), static_cast<uint32_t>(c.size()));
     }
 };
 
 
 template <typename ContainerType>
-struct deserializer<ContainerType, std::enable_if_t<has_clear<ContainerType>::value && has_push_back<ContainerType>::value>>
+struct deserializer<ContainerType, std::enable_if_t<is_resizable_bitwise_container<ContainerType>::value>>
 {
-    static void apply(ContainerType& c, std::istream& is)
+    template <typename Reader>
+    static void apply(ContainerType& c, Reader& r)
     {
-        // std::cout << "Using deserializer for sequential container" << std::endl;
+        // std::cout << "Using deserializer for contiguous container" << std::endl;
 
-        c.clear();
+        read_block(c, r);
+    }
+};
 
-        // Read the len of container
-        uint32_t len = 0;
-        deserialize(len, is);
 
-        // Read objects
-        for (uint32_t i = 0; i < len; i++)
-        {
-            typename ContainerType::value_type obj{};
-            deserialize(obj, is);
-            c.push_back(obj);
-        }
+template <typename ContainerType>
+struct deserializer<ContainerType, std::enable_if_t<has_clear<ContainerType>::value && has_push_back<ContainerType>::value
+                                                   && !is_resizable_bitwise_container<ContainerType>::value>>
+{
+    template <typename Reader>
+    static void apply(ContainerType& c, Reader& r)
+    {
+        // std::cout << "Using deserializer for sequential container" << std::endl;
+
+        read_sequential<is_contiguous_bitwise_container<ContainerType>::value>(c, r);
     }
 };
 
@@ -235,23 +420,12 @@ struct deserializer<ContainerType, std::enable_if_t<has_clear<ContainerType>::va
 template <typename ContainerType>
 struct deserializer<ContainerType, std::enable_if_t<has_size<ContainerType>::value && has_insert<ContainerType>::value>>
 {
-    static void apply(ContainerType& c, std::istream& is)
+    template <typename Reader>
+    static void apply(ContainerType& c, Reader& r)
     {
         // std::cout << "Using deserializer for associative container" << std::endl;
 
-        c.clear();
-
-        // Read the len of container
-        uint32_t len = 0;
-        deserialize(len, is);
-
-        // Read objects
-        for (uint32_t i = 0; i < len; i++)
-        {
-            typename ContainerType::value_type obj{};
-            deserialize(obj, is);
-            c.insert(obj);
-        }
+        read_associative(c, r);
     }
 };
 
@@ -259,17 +433,18 @@ struct deserializer<ContainerType, std::enable_if_t<has_size<ContainerType>::val
 template <typename ContainerType>
 struct serializer<ContainerType, std::enable_if_t<(!has_size<ContainerType>::value) && has_begin_end<ContainerType>::value>>
 {
-    static void apply(const ContainerType& c, std::ostream& os)
+    template <typename Writer>
+    static void apply(const ContainerType& c, Writer& w)
     {
         // std::cout << "Using serializer for forward_list container" << std::endl;
 
-        // Write the len of the container
-        uint32_t len = static_cast<uint32_t>(std::distance(c.begin(), c.end()));
-        serialize(len, os);
+        write_elements(c, static_cast<uint32_t>(std::distance(c.begin(), c.end())), w);
+    }
 
-        // Write objects
-        for (const auto& obj : c)
-            serialize(obj, os);
+    template <typename Encoding>
+    static std::size_t size(const ContainerType& c)
+    {
+        return elements_size<Encoding>(c, static_cast<uint32_t>(std::distance(c.begin(), c.end())));
     }
 };
 
@@ -277,37 +452,46 @@ struct serializer<ContainerType, std::enable_if_t<(!has_size<ContainerType>::val
 template <typename ContainerType>
 struct deserializer<ContainerType, std::enable_if_t<has_clear<ContainerType>::value && has_insert_after<ContainerType>::value && has_before_begin<ContainerType>::value>>
 {
-    static void apply(ContainerType& c, std::istream& is)
+    template <typename Reader>
+    static void apply(ContainerType& c, Reader& r)
     {
         // std::cout << "Using deserializer for forward_list container" << std::endl;
 
-        c.clear();
-
-        // Read the len of container
-        uint32_t len = 0;
-        deserialize(len, is);
-
-        // Read objects
-        auto it = c.before_begin();
-        for (uint32_t i = 0; i < len; i++)
-        {
-            typename ContainerType::value_type obj{};
-            deserialize(obj, is);
-            c.insert_after(it, obj);
-            ++it;
-        }
+        read_forward_list(c, r);
     }
 };
 
 
+
+template <typename T, typename Writer, std::enable_if_t<is_buffer_writer<Writer>::value, int>>
+void serialize(const T& obj, Writer& w)
+{
+    serializer<T>::apply(obj, w);
+}
+
+template <typename T, typename Reader, std::enable_if_t<is_buffer_reader<Reader>::value, int>>
+void deserialize(T& obj, Reader& r)
+{
+    deserializer<T>::apply(obj, r);
+}
+
 template <typename T>
 void serialize(const T& obj, std::ostream& os)
 {
-    serializer<T>::apply(obj, os);
+    StreamWriter w(os);
+    serialize(obj, w);
 }
 
 template <typename T>
 void deserialize(T& obj, std::istream& is)
 {
-    deserializer<T>::apply(obj, is);
+    StreamReader r(is);
+    deserialize(obj, r);
+}
+
+// Exact number of bytes that serialize() will write for the object with the given encoding
+template <typename Encoding, typename T>
+std::size_t serialized_size(const T& obj)
+{
+    return serializer<T>::template size<Encoding>(obj);
 }
\ No newline at end of file
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <type_traits>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define SIMD_SEARCH_X86
+#include <immintrin.h>
+#endif
+
+/*
+Equality and search over blocks of values that compare as their bytes: integers, enums and
+pointers (floating point values don't: 0.0 == -0.0 and NaN != NaN). Used by MyVector.
+
+Equality is one memcmp. find / count compare 32 bytes at a time with AVX2 (vpcmpeq +
+vpmovmskb), the tail is compared one value at a time. The instruction set is chosen at run
+time like in byte_swap.hpp, without AVX2 the scalar loops are used.
+*/
+
+
+template <typename T>
+constexpr bool is_bitwise_comparable = (std::is_integral_v<T> || std::is_enum_v<T> || std::is_pointer_v<T>)
+    && !std::is_same_v<std::remove_cv_t<T>, bool>
+    && (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8);
+
+
+template <typename T>
+bool simd_equal(const T* first, const T* second, std::size_t count)
+{
+    static_assert(is_bitwise_comparable<T>, "simd_equal() needs values that compare as their bytes");
+
+    return count == 0 || std::memcmp(first, second, count * sizeof(T)) == 0;
+}
+
+
+
+#ifdef SIMD_SEARCH_X86
+
+template <std::size_t Size>
+__attribute__((target("avx2")))
+inline __m256i simd_broadcast(const void* value)
+{
+    if constexpr (Size == 1) { int8_t v; std::memcpy(&v, value, 1); return _mm256_set1_epi8(v); }
+    else if constexpr (Size == 2) { int16_t v; std::memcpy(&v, value, 2); return _mm256_set1_epi16(v); }
+    else if constexpr (Size == 4) { int32_t v; std::memcpy(&v, value, 4); return _mm256_set1_epi32(v); }
+    else { int64_t v; std::memcpy(&v, value, 8); return _mm256_set1_epi64x(v); }
+}
+
+// One bit per byte of the block, the bytes of the equal values are set
+template <std::size_t Size>
+__attribute__((target("avx2")))
+inline uint32_t simd_equal_mask(const std::byte* block, __m256i needle)
+{
+    const __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+    __m256i equal;
+    if constexpr (Size == 1) equal = _mm256_cmpeq_epi8(values, needle);
+    else if constexpr (Size == 2) equal = _mm256_cmpeq_epi16(values, needle);
+    else if constexpr (Size == 4) equal = _mm256_cmpeq_epi32(values, needle);
+    else equal = _mm256_cmpeq_epi64(values, needle);
+    return static_cast<uint32_t>(_mm256_movemask_epi8(equal));
+}
+
+// Both kernels look only at the whole 32-byte blocks and report how many values they covered in done
+template <std::size_t Size>
+__attribute__((target("avx2")))
+inline std::size_t simd_find_avx2(const std::byte* data, std::size_t count, const void* value, std::size_t& done)
+{
+    const __m256i needle = simd_broadcast<Size>(value);
+    const std::size_t size = count * Size;
+
+    std::size_t i = 0;
+    for (; i + 32 <= size; i += 32)
+    {
+        const uint32_t mask = simd_equal_mask<Size>(data + i, needle);
+        if (mask != 0)
+        {
+            done = count;
+            return (i + static_cast<std::size_t>(__builtin_ctz(mask))) / Size;
+        }
+    }
+    done = i / Size;
+    return count;
+}
+
+template <std::size_t Size>
+__attribute__((target("avx2,popcnt")))
+inline std::size_t simd_count_avx2(const std::byte* data, std::size_t count, const void* value, std::size_t& done)
+{
+    const __m256i needle = simd_broadcast<Size>(value);
+    const std::size_t size = count * Size;
+
+    std::size_t bits = 0;
+    std::size_t i = 0;
+    for (; i + 32 <= size; i += 32)
+        bits += static_cast<std::size_t>(__builtin_popcount(simd_equal_mask<Size>(data + i, needle)));
+    done = i / Size;
+    return bits / Size;
+}
+
+inline bool simd_search_has_avx2()
+{
+    static const bool has_avx2 = [] {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt");
+    }();
+    return has_avx2;
+}
+
+#endif
+
+
+
+// Index of the first value equal to value, count if there is none
+template <typename T>
+std::size_t simd_find(const T* data, std::size_t count, const T& value)
+{
+    static_assert(is_bitwise_comparable<T>, "simd_find() needs values that compare as their bytes");
+
+    std::size_t done = 0;
+
+#ifdef SIMD_SEARCH_X86
+    if (simd_search_has_avx2())
+    {
+        const std::size_t index = simd_find_avx2<sizeof(T)>(reinterpret_cast<const std::byte*>(data), count, &value, done);
+        if (index != count) return index;
+    }
+#endif
+
+    for (std::size_t i = done; i < count; ++i)
+        if (data[i] == value) return i;
+    return count;
+}
+
+template <typename T>
+std::size_t simd_count(const T* data, std::size_t count, const T& value)
+{
+    static_assert(is_bitwise_comparable<T>, "simd_count() needs values that compare as their bytes");
+
+    std::size_t result = 0;
+    std::size_t done = 0;
+
+#ifdef SIMD_SEARCH_X86
+    if (simd_search_has_avx2())
+        result = simd_count_avx2<sizeof(T)>(reinterpret_cast<const std::byte*>(data), count, &value, done);
+#endif
+
+    for (std::size_t i = done; i < count; ++i)
+        result += data[i] == value ? 1 : 0;
+    return result;
+}
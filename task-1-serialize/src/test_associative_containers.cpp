@@ -11,6 +11,7 @@
 // #include <serialize_concepts.hpp>
 // #include <serialize_sfinae.hpp>
 #include "serialize.hpp"
+#include "serialize_instrumentation.hpp"
 
 
 // std::map tests
@@ -174,6 +175,22 @@ TEST(TestMap, MapLarge) {
     EXPECT_EQ(m, deserialized_m);
 }
 
+TEST(TestMap, MultimapKeepsOrderOfEqualKeys) {
+    std::multimap<std::string, int> m = {{"b", 1}, {"a", 2}, {"b", 3}, {"b", 2}, {"a", 1}};
+    
+    std::ostringstream oss(std::stringstream::binary);
+
+    serialize(m, oss);
+
+    std::istringstream iss(oss.str(), std::stringstream::binary);
+
+    std::multimap<std::string, int> deserialized_m = {{"trash", 0}};
+
+    deserialize(deserialized_m, iss);
+
+    EXPECT_EQ(m, deserialized_m);
+}
+
 
 // std::set tests
 TEST(TestSet, SetIntEmpty) {
@@ -316,6 +333,70 @@ TEST(TestSet, SetLarge) {
 }
 
 
+// std::unordered_map / std::unordered_set tests
+TEST(TestUnorderedMap, UnorderedMapStringToVector) {
+    std::unordered_map<std::string, std::vector<int>> m;
+    for (int i = 0; i < 1000; ++i)
+        m["k" + std::to_string(i)] = std::vector<int>(i % 5 + 1, i);
+
+    std::vector<std::byte> buffer;
+    VectorWriter w(buffer);
+    serialize(m, w);
+
+    std::unordered_map<std::string, std::vector<int>> deserialized_m;
+    SpanReader r(buffer);
+    SerializeCounters c = counted_deserialize(deserialized_m, r);
+
+    EXPECT_EQ(m, deserialized_m);
+
+    // The buckets are reserved once before the insertions, so the table has the size reserve() gives
+    std::unordered_map<std::string, std::vector<int>> reserved_m;
+    reserved_m.reserve(m.size());
+    EXPECT_EQ(deserialized_m.bucket_count(), reserved_m.bucket_count());
+
+    // One node and one vector per element, the rest is the bucket array (and a sentinel in some
+    // standard libraries): no rehashes, no copies
+    EXPECT_LE(c.allocations, 2 * m.size() + 2);
+}
+
+TEST(TestUnorderedMap, UnorderedMultimapKeepsEqualKeys) {
+    std::unordered_multimap<std::string, int> m = {{"b", 1}, {"a", 2}, {"b", 3}, {"b", 2}, {"a", 1}};
+    
+    std::ostringstream oss(std::stringstream::binary);
+
+    serialize(m, oss);
+
+    std::istringstream iss(oss.str(), std::stringstream::binary);
+
+    std::unordered_multimap<std::string, int> deserialized_m = {{"trash", 0}};
+
+    deserialize(deserialized_m, iss);
+
+    EXPECT_EQ(m, deserialized_m);
+}
+
+TEST(TestUnorderedSet, UnorderedSetAndMultiset) {
+    std::unordered_set<std::string> s = {"one", "two", "three", ""};
+    std::unordered_multiset<int> ms = {1, 1, 2, 3, 3, 3};
+    
+    std::ostringstream oss(std::stringstream::binary);
+
+    serialize(s, oss);
+    serialize(ms, oss);
+
+    std::istringstream iss(oss.str(), std::stringstream::binary);
+
+    std::unordered_set<std::string> deserialized_s = {"trash"};
+    std::unordered_multiset<int> deserialized_ms = {100};
+
+    deserialize(deserialized_s, iss);
+    deserialize(deserialized_ms, iss);
+
+    EXPECT_EQ(s, deserialized_s);
+    EXPECT_EQ(ms, deserialized_ms);
+}
+
+
 // Complex structure
 using SuperContainer = std::vector<
     std::unordered_map<
@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+#include <map>
+#include <string>
+#include <tuple>
+
+// #include <serialize_concepts.hpp>
+// #include <serialize_sfinae.hpp>
+#include "serialize.hpp"
+#include "batch_serialize.hpp"
+#include "serialize_instrumentation.hpp"
+
+
+TEST(TestBatch, SerializeAllMatchesConsecutiveCalls)
+{
+    const int id = 42;
+    const std::string name = "snapshot";
+    const std::vector<double> position = {1.5, -2.0, 3.25};
+    const std::map<std::string, int> tags = {{"a", 1}, {"b", 2}};
+
+    std::ostringstream one_by_one(std::stringstream::binary);
+    serialize(id, one_by_one);
+    serialize(name, one_by_one);
+    serialize(position, one_by_one);
+    serialize(tags, one_by_one);
+
+    std::ostringstream batch(std::stringstream::binary);
+    serialize_all(batch, id, name, position, tags);
+
+    EXPECT_TRUE(batch.good());
+    EXPECT_EQ(batch.str(), one_by_one.str());
+}
+
+TEST(TestBatch, DeserializeAll)
+{
+    std::stringstream ss(std::stringstream::in | std::stringstream::out | std::stringstream::binary);
+    serialize_all(ss, 7, std::string("name"), std::vector<int>{1, 2, 3});
+
+    int id = 0;
+    std::string name;
+    std::vector<int> values = {100};
+    deserialize_all(ss, id, name, values);
+
+    EXPECT_TRUE(ss.good());
+    EXPECT_EQ(id, 7);
+    EXPECT_EQ(name, "name");
+    EXPECT_EQ(values, std::vector<int>({1, 2, 3}));
+}
+
+TEST(TestBatch, OneWriteForTheWholeBatch)
+{
+    std::vector<std::string> states;
+    for (int i = 0; i < 1000; ++i)
+        states.push_back("state " + std::to_string(i));
+
+    std::vector<std::byte> buffer;
+    VectorWriter inner(buffer);
+    InstrumentedWriter<VectorWriter> w(inner);
+
+    ScopedSerializeCounters scope;
+    serialize_range(states.begin(), states.end(), w);
+    const SerializeCounters c = scope.counters();
+
+    EXPECT_EQ(c.stream_calls, 1u);
+    EXPECT_EQ(c.bytes_copied, buffer.size());
+
+    std::vector<std::string> result(states.size());
+    SpanReader r(buffer);
+    deserialize_range(result.begin(), result.end(), r);
+
+    EXPECT_EQ(result, states);
+    EXPECT_EQ(r.remaining(), 0u);
+}
+
+TEST(TestBatch, RangeThroughStreams)
+{
+    const std::vector<std::map<int, std::string>> states = {{{1, "one"}}, {}, {{2, "two"}, {3, "three"}}};
+
+    std::stringstream ss(std::stringstream::in | std::stringstream::out | std::stringstream::binary);
+    serialize_range(states.begin(), states.end(), ss);
+
+    std::vector<std::map<int, std::string>> result(states.size());
+    deserialize_range(result.begin(), result.end(), ss);
+
+    EXPECT_TRUE(ss.good());
+    EXPECT_EQ(result, states);
+}
+
+TEST(TestBatch, EmptyBatchWritesNothing)
+{
+    std::ostringstream oss(std::stringstream::binary);
+    serialize_all(oss);
+
+    const std::vector<int> empty;
+    serialize_range(empty.begin(), empty.end(), oss);
+
+    EXPECT_TRUE(oss.good());
+    EXPECT_TRUE(oss.str().empty());
+}
+
+TEST(TestBatch, KeepsTheEncodingOfTheWriter)
+{
+    const std::tuple<uint64_t, std::string, std::vector<int>> snapshot = {300, "compact", {-1, 1, 1000}};
+
+    std::vector<std::byte> expected;
+    {
+        VectorWriter inner(expected);
+        auto w = with_encoding<VarintEncoding>(inner);
+        serialize(std::get<0>(snapshot), w);
+        serialize(std::get<1>(snapshot), w);
+        serialize(std::get<2>(snapshot), w);
+    }
+
+    std::vector<std::byte> buffer;
+    VectorWriter inner(buffer);
+    auto w = with_encoding<VarintEncoding>(inner);
+    std::apply([&](const auto&... objs) { serialize_all(w, objs...); }, snapshot);
+
+    ASSERT_EQ(buffer.size(), expected.size());
+    EXPECT_EQ(std::memcmp(buffer.data(), expected.data(), buffer.size()), 0);
+
+    uint64_t number = 0;
+    std::string str;
+    std::vector<int> vec;
+    SpanReader r_inner(buffer);
+    auto r = with_decoding<VarintEncoding>(r_inner);
+    deserialize_all(r, number, str, vec);
+
+    EXPECT_EQ(std::make_tuple(number, str, vec), snapshot);
+}
@@ -0,0 +1,166 @@
+#include <gtest/gtest.h>
+
+#include <iostream>
+#include <sstream>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <string>
+
+// #include <serialize_concepts.hpp>
+// #include <serialize_sfinae.hpp>
+#include "serialize.hpp"
+
+
+TEST(TestBuffers, VectorWriterMatchesStream)
+{
+    std::map<std::string, std::vector<int>> m = {
+        {"first", {1, 2, 3}},
+        {"second", {}},
+        {"third", {-1, 0, INT_MAX}}
+    };
+
+    std::ostringstream oss(std::stringstream::binary);
+    serialize(m, oss);
+
+    std::vector<std::byte> buffer;
+    VectorWriter w(buffer);
+    serialize(m, w);
+
+    const std::string stream_bytes = oss.str();
+    ASSERT_EQ(buffer.size(), stream_bytes.size());
+    EXPECT_EQ(std::memcmp(buffer.data(), stream_bytes.data(), buffer.size()), 0);
+}
+
+TEST(TestBuffers, VectorWriterAppends)
+{
+    std::vector<std::byte> buffer;
+    VectorWriter w(buffer);
+
+    serialize(std::string("hello"), w);
+    serialize(42, w);
+
+    EXPECT_EQ(w.size(), sizeof(uint32_t) + 5 + sizeof(int));
+
+    SpanReader r(buffer);
+    std::string str{};
+    int value = 0;
+    deserialize(str, r);
+    deserialize(value, r);
+
+    EXPECT_EQ(str, "hello");
+    EXPECT_EQ(value, 42);
+    EXPECT_EQ(r.remaining(), 0u);
+}
+
+TEST(TestBuffers, PreallocatedSpanRoundTrip)
+{
+    std::map<std::string, std::vector<int>> m = {
+        {"alpha", {10, 20}},
+        {"beta", {30}},
+        {"", {}}
+    };
+
+    std::vector<std::byte> buffer(1024);
+    SpanWriter w(buffer);
+    serialize(m, w);
+
+    SpanReader r(std::span<const std::byte>(buffer.data(), w.position()));
+    std::map<std::string, std::vector<int>> deserialized_m{};
+    deserialize(deserialized_m, r);
+
+    EXPECT_EQ(m, deserialized_m);
+    EXPECT_EQ(r.remaining(), 0u);
+}
+
+TEST(TestBuffers, SpanWriterOverflowThrows)
+{
+    std::vector<int> vec = {1, 2, 3, 4};
+
+    std::vector<std::byte> buffer(sizeof(uint32_t) + 2 * sizeof(int));
+    SpanWriter w(buffer);
+
+    EXPECT_THROW(serialize(vec, w), SerializeBufferError);
+}
+
+TEST(TestBuffers, SpanReaderUnderflowThrows)
+{
+    std::vector<std::byte> buffer;
+    VectorWriter w(buffer);
+    serialize(std::string("truncated"), w);
+    buffer.resize(buffer.size() - 1);
+
+    SpanReader r(buffer);
+    std::string str{};
+
+    EXPECT_THROW(deserialize(str, r), SerializeBufferError);
+}
+
+TEST(TestBuffers, StreamReaderSetsFailbit)
+{
+    std::istringstream iss(std::string("\x01\x02", 2), std::stringstream::binary);
+
+    int value = 0;
+    deserialize(value, iss);
+
+    EXPECT_TRUE(iss.fail());
+    EXPECT_TRUE(iss.eof());
+}
+
+TEST(TestBuffers, CorruptLengthDoesNotAllocateAhead)
+{
+    // A length of almost 4G elements followed by a few bytes
+    std::vector<std::byte> buffer;
+    VectorWriter w(buffer);
+    serialize(uint32_t{0xFFFFFFF0}, w);
+    serialize(std::string("abc"), w);
+
+    std::string str{};
+    std::vector<int> ints{};
+    std::vector<std::string> strings{};
+    std::unordered_map<int, int> map{};
+    {
+        SpanReader r(buffer);
+        EXPECT_THROW(deserialize(str, r), SerializeBufferError);
+    }
+    {
+        SpanReader r(buffer);
+        EXPECT_THROW(deserialize(ints, r), SerializeBufferError);
+    }
+    {
+        SpanReader r(buffer);
+        EXPECT_THROW(deserialize(strings, r), SerializeBufferError);
+    }
+    {
+        SpanReader r(buffer);
+        EXPECT_THROW(deserialize(map, r), SerializeBufferError);
+    }
+
+    // A stream doesn't know its size, the string grows by a bounded step and stops on the failure
+    std::istringstream iss(std::string(reinterpret_cast<const char*>(buffer.data()), buffer.size()), std::stringstream::binary);
+    deserialize(str, iss);
+    EXPECT_TRUE(iss.fail());
+    EXPECT_LE(str.size(), UNTRUSTED_GROWTH_BYTES);
+}
+
+TEST(TestBuffers, StreamWriterAndReaderAdapters)
+{
+    std::vector<std::string> vec = {"one", "two", "three"};
+
+    std::stringstream ss(std::stringstream::in | std::stringstream::out | std::stringstream::binary);
+    {
+        StreamWriter w(ss);
+        serialize(vec, w);
+    }
+
+    std::vector<std::string> deserialized_vector{};
+    {
+        StreamReader r(ss);
+        deserialize(deserialized_vector, r);
+    }
+
+    EXPECT_EQ(vec, deserialized_vector);
+    EXPECT_TRUE(ss.good());
+}
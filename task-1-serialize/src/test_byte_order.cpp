@@ -0,0 +1,187 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <map>
+#include <string>
+#include "my_vector.hpp"
+
+// #include <serialize_concepts.hpp>
+// #include <serialize_sfinae.hpp>
+#include "serialize.hpp"
+
+
+struct Sample
+{
+    uint16_t id;
+    uint32_t flags;
+    double value;
+    std::string name;
+
+    bool operator==(const Sample&) const = default;
+};
+SERIALIZE_FIELDS(Sample, id, flags, value, name)
+
+
+namespace
+{
+    template <typename Encoding, typename T>
+    std::vector<std::byte> serialize_with(const T& obj)
+    {
+        std::vector<std::byte> buffer;
+        VectorWriter inner(buffer);
+        auto w = with_encoding<Encoding>(inner);
+        serialize(obj, w);
+        return buffer;
+    }
+
+    template <typename Encoding, typename T>
+    T round_trip(const T& obj)
+    {
+        const std::vector<std::byte> buffer = serialize_with<Encoding>(obj);
+
+        T result{};
+        SpanReader inner(buffer);
+        auto r = with_decoding<Encoding>(inner);
+        deserialize(result, r);
+        EXPECT_EQ(inner.remaining(), 0u);
+        return result;
+    }
+
+    // Bytes of the value from the most significant one, independent of the host
+    std::vector<std::byte> big_endian_bytes(uint64_t value, std::size_t size)
+    {
+        std::vector<std::byte> bytes(size);
+        for (std::size_t i = 0; i < size; ++i)
+            bytes[size - 1 - i] = static_cast<std::byte>(value >> (8 * i));
+        return bytes;
+    }
+
+    std::vector<std::byte> little_endian_bytes(uint64_t value, std::size_t size)
+    {
+        std::vector<std::byte> bytes(size);
+        for (std::size_t i = 0; i < size; ++i)
+            bytes[i] = static_cast<std::byte>(value >> (8 * i));
+        return bytes;
+    }
+}
+
+
+TEST(TestByteOrder, ScalarsHaveTheByteOrderOfTheEncoding)
+{
+    EXPECT_EQ(serialize_with<BigEndianEncoding>(uint32_t{0x01020304}), big_endian_bytes(0x01020304, 4));
+    EXPECT_EQ(serialize_with<LittleEndianEncoding>(uint32_t{0x01020304}), little_endian_bytes(0x01020304, 4));
+    EXPECT_EQ(serialize_with<BigEndianEncoding>(int16_t{-2}), big_endian_bytes(0xFFFE, 2));
+    EXPECT_EQ(serialize_with<BigEndianEncoding>(uint64_t{0x0102030405060708}), big_endian_bytes(0x0102030405060708, 8));
+
+    double value = 1.5;
+    uint64_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    EXPECT_EQ(serialize_with<BigEndianEncoding>(value), big_endian_bytes(bits, 8));
+}
+
+TEST(TestByteOrder, LengthsHaveTheByteOrderOfTheEncoding)
+{
+    std::vector<std::byte> expected = big_endian_bytes(3, 4);
+    expected.push_back(std::byte{'a'});
+    expected.push_back(std::byte{'b'});
+    expected.push_back(std::byte{'c'});
+
+    EXPECT_EQ(serialize_with<BigEndianEncoding>(std::string("abc")), expected);
+}
+
+TEST(TestByteOrder, LittleEndianIsFixedOnLittleEndianHosts)
+{
+    if constexpr (std::endian::native != std::endian::little)
+        GTEST_SKIP() << "The host is not little-endian";
+
+    const std::map<std::string, std::vector<double>> m = {{"a", {1.0, 2.0}}, {"b", {}}};
+    EXPECT_EQ(serialize_with<LittleEndianEncoding>(m), serialize_with<FixedEncoding>(m));
+}
+
+TEST(TestByteOrder, BlocksAreSwappedElementByElement)
+{
+    // Sizes around the vector width, so both the SIMD part and the scalar tail are used
+    for (std::size_t size : {std::size_t{1}, std::size_t{7}, std::size_t{8}, std::size_t{9}, std::size_t{33}, std::size_t{5000}})
+    {
+        std::vector<uint32_t> vec(size);
+        for (std::size_t i = 0; i < size; ++i)
+            vec[i] = static_cast<uint32_t>(i * 0x01010101u + 0x00010203u);
+
+        std::vector<std::byte> expected = big_endian_bytes(size, 4);
+        for (uint32_t value : vec)
+        {
+            const std::vector<std::byte> bytes = big_endian_bytes(value, 4);
+            expected.insert(expected.end(), bytes.begin(), bytes.end());
+        }
+
+        EXPECT_EQ(serialize_with<BigEndianEncoding>(vec), expected) << "size " << size;
+        EXPECT_EQ(round_trip<BigEndianEncoding>(vec), vec) << "size " << size;
+    }
+}
+
+TEST(TestByteOrder, RoundTripOfAllScalarWidths)
+{
+    std::vector<int16_t> shorts;
+    std::vector<uint64_t> longs;
+    std::vector<float> floats;
+    std::vector<double> doubles;
+    for (int i = 0; i < 1000; ++i)
+    {
+        shorts.push_back(static_cast<int16_t>(i * 37 - 5000));
+        longs.push_back(static_cast<uint64_t>(i) * 0x0123456789ABull);
+        floats.push_back(static_cast<float>(i) / 3.0f);
+        doubles.push_back(-static_cast<double>(i) / 7.0);
+    }
+
+    EXPECT_EQ(round_trip<BigEndianEncoding>(shorts), shorts);
+    EXPECT_EQ(round_trip<BigEndianEncoding>(longs), longs);
+    EXPECT_EQ(round_trip<BigEndianEncoding>(floats), floats);
+    EXPECT_EQ(round_trip<BigEndianEncoding>(doubles), doubles);
+    EXPECT_EQ(round_trip<LittleEndianEncoding>(doubles), doubles);
+}
+
+TEST(TestByteOrder, NestedContainersAndMyVector)
+{
+    const std::map<std::string, std::vector<int>> m = {{"first", {1, -2, 3}}, {"second", {}}, {"third", {INT32_MIN, INT32_MAX}}};
+    EXPECT_EQ(round_trip<BigEndianEncoding>(m), m);
+
+    MyVector<uint32_t> my_vector;
+    for (uint32_t i = 0; i < 100; ++i)
+        my_vector.push_back(i * 0x10001u);
+    EXPECT_EQ(round_trip<BigEndianEncoding>(my_vector), my_vector);
+}
+
+TEST(TestByteOrder, ListedStructFieldsAreSwapped)
+{
+    const Sample sample{0x0102, 0x03040506, 2.5, "sample"};
+
+    std::vector<std::byte> expected = big_endian_bytes(0x0102, 2);
+    const std::vector<std::byte> flags = big_endian_bytes(0x03040506, 4);
+    expected.insert(expected.end(), flags.begin(), flags.end());
+
+    const std::vector<std::byte> buffer = serialize_with<BigEndianEncoding>(sample);
+    ASSERT_GE(buffer.size(), expected.size());
+    EXPECT_TRUE(std::equal(expected.begin(), expected.end(), buffer.begin()));
+
+    EXPECT_EQ(round_trip<BigEndianEncoding>(sample), sample);
+}
+
+TEST(TestByteOrder, SwapKernelMatchesScalarSwap)
+{
+    std::vector<uint64_t> values(1000);
+    for (std::size_t i = 0; i < values.size(); ++i)
+        values[i] = i * 0x0102030405060708ull;
+
+    // Unaligned start and every length up to a few vectors
+    for (std::size_t offset = 0; offset < 3; ++offset)
+        for (std::size_t count = 0; count < 20; ++count)
+        {
+            std::vector<uint64_t> swapped(values.begin() + offset, values.begin() + offset + count);
+            byte_swap_block(swapped.data(), swapped.size());
+            for (std::size_t i = 0; i < count; ++i)
+                EXPECT_EQ(swapped[i], std::byteswap(values[offset + i]));
+        }
+}
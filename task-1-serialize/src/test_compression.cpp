@@ -0,0 +1,203 @@
+#include <gtest/gtest.h>
+
+#include <iostream>
+#include <sstream>
+#include <cstddef>
+#include <vector>
+#include <map>
+#include <string>
+#include <random>
+
+// #include <serialize_concepts.hpp>
+// #include <serialize_sfinae.hpp>
+#include "serialize.hpp"
+#include "block_compression.hpp"
+
+
+namespace
+{
+    std::map<std::string, int> make_repetitive_map(int count)
+    {
+        std::map<std::string, int> mp;
+        for (int i = 0; i < count; ++i)
+            mp["user.settings.option_" + std::to_string(i)] = i % 10;
+        return mp;
+    }
+
+    std::vector<std::byte> round_trip_block(const std::vector<std::byte>& block)
+    {
+        std::vector<std::byte> compressed;
+        std::vector<uint32_t> table;
+        lz_compress_block(block, compressed, table);
+
+        std::vector<std::byte> decompressed(block.size());
+        lz_decompress_block(compressed, decompressed);
+        return decompressed;
+    }
+}
+
+
+TEST(TestCompression, CodecRoundTrip)
+{
+    std::vector<std::byte> empty{};
+    EXPECT_EQ(round_trip_block(empty), empty);
+
+    std::vector<std::byte> short_block = {std::byte{1}, std::byte{2}, std::byte{3}};
+    EXPECT_EQ(round_trip_block(short_block), short_block);
+
+    // Long runs need extra length bytes and overlapping matches
+    std::vector<std::byte> runs(100000, std::byte{'a'});
+    for (std::size_t i = 0; i < runs.size(); i += 1000)
+        runs[i] = std::byte{'b'};
+    EXPECT_EQ(round_trip_block(runs), runs);
+
+    std::mt19937 gen(42);
+    std::vector<std::byte> random(70000);
+    for (auto& byte : random)
+        byte = static_cast<std::byte>(gen());
+    EXPECT_EQ(round_trip_block(random), random);
+}
+
+TEST(TestCompression, MapThroughCompressedStream)
+{
+    const auto mp = make_repetitive_map(20000);
+
+    for (std::size_t block_size : {std::size_t{100}, std::size_t{4096}, DEFAULT_COMPRESSION_BLOCK_SIZE})
+    {
+        std::vector<std::byte> buffer;
+        VectorWriter inner_writer(buffer);
+        {
+            CompressedWriter w(inner_writer, block_size);
+            serialize(mp, w);
+        }
+        if (block_size >= 4096)
+        {
+            EXPECT_LT(buffer.size(), serialized_size(mp) / 2);
+        }
+
+        SpanReader inner_reader(buffer);
+        CompressedReader r(inner_reader);
+        std::map<std::string, int> deserialized_map = {{"trash", 0}};
+        deserialize(deserialized_map, r);
+
+        EXPECT_EQ(mp, deserialized_map);
+        EXPECT_EQ(r.position(), serialized_size(mp));
+    }
+}
+
+TEST(TestCompression, FinishReadsTheEndOfStream)
+{
+    const auto mp = make_repetitive_map(1000);
+
+    std::vector<std::byte> buffer;
+    VectorWriter inner_writer(buffer);
+    {
+        CompressedWriter w(inner_writer, 100);
+        serialize(mp, w);
+    }
+    serialize(12345, inner_writer);
+
+    // The block headers are little-endian on every host
+    EXPECT_EQ(buffer[0], std::byte{100});
+    EXPECT_EQ(buffer[1], std::byte{0});
+
+    SpanReader inner_reader(buffer);
+    {
+        CompressedReader r(inner_reader);
+        std::map<std::string, int> deserialized_map{};
+        deserialize(deserialized_map, r);
+        r.finish();
+        r.finish();
+        EXPECT_EQ(mp, deserialized_map);
+    }
+
+    int after = 0;
+    deserialize(after, inner_reader);
+    EXPECT_EQ(after, 12345);
+    EXPECT_EQ(inner_reader.remaining(), 0u);
+
+    // Data left in the compressed stream
+    SpanReader unfinished_reader(buffer);
+    CompressedReader r(unfinished_reader);
+    uint32_t len = 0;
+    deserialize(len, r);
+    EXPECT_THROW(r.finish(), SerializeBufferError);
+}
+
+TEST(TestCompression, StreamsAndEncoding)
+{
+    std::vector<long long> vec(10000, -3);
+
+    std::ostringstream oss(std::stringstream::binary);
+    {
+        StreamWriter inner_writer(oss);
+        auto encoded_writer = with_encoding<VarintEncoding>(inner_writer);
+        CompressedWriter w(encoded_writer, 1000);
+        serialize(vec, w);
+        w.finish();
+    }
+
+    std::istringstream iss(oss.str(), std::stringstream::binary);
+    StreamReader inner_reader(iss);
+    auto encoded_reader = with_decoding<VarintEncoding>(inner_reader);
+    CompressedReader r(encoded_reader);
+    std::vector<long long> deserialized_vector{};
+    deserialize(deserialized_vector, r);
+
+    EXPECT_EQ(vec, deserialized_vector);
+}
+
+TEST(TestCompression, ParallelDecompression)
+{
+    const auto mp = make_repetitive_map(50000);
+
+    std::vector<std::byte> buffer;
+    VectorWriter inner_writer(buffer);
+    {
+        CompressedWriter w(inner_writer, 4096);
+        serialize(mp, w);
+    }
+
+    for (std::size_t threads : {1u, 4u})
+    {
+        const std::vector<std::byte> decompressed = decompress_parallel(buffer, threads);
+        EXPECT_EQ(decompressed.size(), serialized_size(mp));
+
+        SpanReader r(decompressed);
+        std::map<std::string, int> deserialized_map{};
+        deserialize(deserialized_map, r);
+        EXPECT_EQ(mp, deserialized_map);
+    }
+}
+
+TEST(TestCompression, InvalidDataThrows)
+{
+    const auto mp = make_repetitive_map(1000);
+
+    std::vector<std::byte> buffer;
+    VectorWriter inner_writer(buffer);
+    {
+        CompressedWriter w(inner_writer);
+        serialize(mp, w);
+    }
+
+    // Reading past the end of the stream
+    {
+        SpanReader inner_reader(buffer);
+        CompressedReader r(inner_reader);
+        std::map<std::string, int> deserialized_map{};
+        deserialize(deserialized_map, r);
+
+        int extra = 0;
+        EXPECT_THROW(deserialize(extra, r), SerializeBufferError);
+    }
+
+    // A match that points before the beginning of the block
+    const std::vector<std::byte> bad_block = {std::byte{0x10}, std::byte{'a'}, std::byte{5}, std::byte{0}};
+    std::vector<std::byte> out(10);
+    EXPECT_THROW(lz_decompress_block(bad_block, out), SerializeBufferError);
+
+    auto truncated = buffer;
+    truncated.resize(truncated.size() / 2);
+    EXPECT_THROW(decompress_parallel(truncated, 2), SerializeBufferError);
+}
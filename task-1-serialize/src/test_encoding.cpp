@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+
+#include <iostream>
+#include <sstream>
+#include <cstddef>
+#include <climits>
+#include <vector>
+#include <forward_list>
+#include <map>
+#include <set>
+#include <string>
+#include "my_vector.hpp"
+
+// #include <serialize_concepts.hpp>
+// #include <serialize_sfinae.hpp>
+#include "serialize.hpp"
+
+
+namespace
+{
+    template <typename T>
+    std::vector<std::byte> serialize_varint(const T& obj)
+    {
+        std::vector<std::byte> buffer;
+        VectorWriter inner(buffer);
+        auto w = with_encoding<VarintEncoding>(inner);
+        serialize(obj, w);
+        return buffer;
+    }
+
+    template <typename T>
+    T deserialize_varint(const std::vector<std::byte>& buffer)
+    {
+        SpanReader inner(buffer);
+        auto r = with_decoding<VarintEncoding>(inner);
+        T obj{};
+        deserialize(obj, r);
+        EXPECT_EQ(inner.remaining(), 0u);
+        return obj;
+    }
+}
+
+
+TEST(TestEncoding, Zigzag)
+{
+    EXPECT_EQ(zigzag_encode(0), 0u);
+    EXPECT_EQ(zigzag_encode(-1), 1u);
+    EXPECT_EQ(zigzag_encode(1), 2u);
+    EXPECT_EQ(zigzag_encode(-2), 3u);
+    EXPECT_EQ(zigzag_decode(zigzag_encode(LLONG_MIN)), LLONG_MIN);
+    EXPECT_EQ(zigzag_decode(zigzag_encode(LLONG_MAX)), LLONG_MAX);
+}
+
+TEST(TestEncoding, VarintSizes)
+{
+    EXPECT_EQ(serialize_varint(0).size(), 1u);
+    EXPECT_EQ(serialize_varint(-64).size(), 1u);
+    EXPECT_EQ(serialize_varint(64).size(), 2u);
+    EXPECT_EQ(serialize_varint(uint8_t{200}).size(), 2u);
+    EXPECT_EQ(serialize_varint(ULLONG_MAX).size(), MAX_VARINT_SIZE);
+}
+
+TEST(TestEncoding, IntegralLimits)
+{
+    EXPECT_EQ(deserialize_varint<int>(serialize_varint(INT_MIN)), INT_MIN);
+    EXPECT_EQ(deserialize_varint<int>(serialize_varint(INT_MAX)), INT_MAX);
+    EXPECT_EQ(deserialize_varint<long long>(serialize_varint(LLONG_MIN)), LLONG_MIN);
+    EXPECT_EQ(deserialize_varint<unsigned long long>(serialize_varint(ULLONG_MAX)), ULLONG_MAX);
+    EXPECT_EQ(deserialize_varint<char>(serialize_varint('\n')), '\n');
+    EXPECT_EQ(deserialize_varint<bool>(serialize_varint(true)), true);
+}
+
+TEST(TestEncoding, MalformedVarints)
+{
+    // ULLONG_MAX ends with 0x01, any other bit in the 10th byte is out of range
+    auto overlong = serialize_varint(ULLONG_MAX);
+    overlong.back() = std::byte{0x02};
+    EXPECT_THROW(deserialize_varint<unsigned long long>(overlong), SerializeBufferError);
+
+    // A length above UINT32_MAX must not be truncated to a small one
+    auto too_long = serialize_varint(uint64_t{UINT32_MAX} + 1);
+    too_long.push_back(std::byte{'a'});
+    EXPECT_THROW(deserialize_varint<std::string>(too_long), SerializeBufferError);
+
+    EXPECT_EQ(deserialize_varint<std::string>(serialize_varint(std::string("ok"))), "ok");
+}
+
+TEST(TestEncoding, FloatingPointIsNotVarint)
+{
+    const double value = -2.718;
+
+    auto buffer = serialize_varint(value);
+
+    EXPECT_EQ(buffer.size(), sizeof(double));
+    EXPECT_EQ(deserialize_varint<double>(buffer), value);
+}
+
+TEST(TestEncoding, StringsAndVectors)
+{
+    std::string str = "short";
+    std::vector<int> ints = {0, 1, -1, 300, -300, INT_MAX, INT_MIN};
+    std::vector<double> doubles = {0.5, -1.5};
+    std::vector<std::string> strings = {"", "a", "bb"};
+
+    EXPECT_EQ(serialize_varint(str).size(), 1 + str.size());
+    EXPECT_EQ(deserialize_varint<std::string>(serialize_varint(str)), str);
+    EXPECT_EQ(deserialize_varint<std::vector<int>>(serialize_varint(ints)), ints);
+    EXPECT_EQ(deserialize_varint<std::vector<double>>(serialize_varint(doubles)), doubles);
+    EXPECT_EQ(deserialize_varint<std::vector<std::string>>(serialize_varint(strings)), strings);
+}
+
+TEST(TestEncoding, AssociativeAndCustomContainers)
+{
+    std::map<std::string, int> m = {{"alpha", 1}, {"beta", -2}, {"gamma", 300}};
+    std::set<long long> s = {-5, 0, 5, LLONG_MAX};
+    std::forward_list<short> fl = {1, -1, SHRT_MAX};
+    MyVector<int> my_vector;
+    my_vector.push_back(7);
+    my_vector.push_back(-7);
+
+    EXPECT_EQ((deserialize_varint<std::map<std::string, int>>(serialize_varint(m))), m);
+    EXPECT_EQ(deserialize_varint<std::set<long long>>(serialize_varint(s)), s);
+    EXPECT_EQ(deserialize_varint<std::forward_list<short>>(serialize_varint(fl)), fl);
+    EXPECT_EQ(deserialize_varint<MyVector<int>>(serialize_varint(my_vector)), my_vector);
+}
+
+TEST(TestEncoding, SerializedSizeMatches)
+{
+    std::map<std::string, std::vector<int>> m = {{"a", {1, 2, 1000}}, {"b", {}}, {"c", {-70000}}};
+    std::vector<long long> vec = {0, -1, 1LL << 40};
+
+    EXPECT_EQ(serialized_size<VarintEncoding>(m), serialize_varint(m).size());
+    EXPECT_EQ(serialized_size<VarintEncoding>(vec), serialize_varint(vec).size());
+    EXPECT_LT(serialized_size<VarintEncoding>(m), serialized_size(m));
+}
+
+TEST(TestEncoding, StreamAdapters)
+{
+    std::map<int, std::string> m = {{-1, "minus one"}, {1000, "thousand"}};
+
+    std::ostringstream oss(std::stringstream::binary);
+    {
+        StreamWriter inner(oss);
+        auto w = with_encoding<VarintEncoding>(inner);
+        serialize(m, w);
+    }
+
+    std::istringstream iss(oss.str(), std::stringstream::binary);
+    std::map<int, std::string> deserialized_m{};
+    {
+        StreamReader inner(iss);
+        auto r = with_decoding<VarintEncoding>(inner);
+        deserialize(deserialized_m, r);
+    }
+
+    EXPECT_EQ(m, deserialized_m);
+    EXPECT_EQ(oss.str().size(), serialized_size<VarintEncoding>(m));
+}
@@ -0,0 +1,162 @@
+#include <gtest/gtest.h>
+
+#include <iostream>
+#include <sstream>
+#include <cstddef>
+#include <vector>
+#include <map>
+#include <string>
+
+// #include <serialize_concepts.hpp>
+// #include <serialize_sfinae.hpp>
+#include "serialize.hpp"
+
+
+struct Person
+{
+    std::string name;
+    int age;
+    int height;
+    double weight;
+    std::vector<int> scores;
+
+    bool operator==(const Person&) const = default;
+};
+SERIALIZE_FIELDS(Person, name, age, height, weight, scores)
+
+
+// Padding after `tag` and after `count`
+struct Padded
+{
+    char tag;
+    double value;
+    int count;
+
+    bool operator==(const Padded&) const = default;
+};
+SERIALIZE_FIELDS(Padded, tag, value, count)
+
+
+struct Team
+{
+    std::string title;
+    std::map<std::string, Person> members;
+    Padded stats;
+
+    bool operator==(const Team&) const = default;
+};
+SERIALIZE_FIELDS(Team, title, members, stats)
+
+
+static_assert(raw_run_end<Person, FixedEncoding, 1>() == 4, "age, height and weight are one run");
+static_assert(raw_run_end<Person, VarintEncoding, 1>() == 1, "integral fields are varints in the compact encoding");
+static_assert(raw_run_end<Padded, FixedEncoding, 0>() == 1, "padding breaks the run");
+
+
+TEST(TestFields, StructWithStringAndVector)
+{
+    Person person{"Alice", 30, 170, 60.5, {1, 2, 3}};
+
+    std::ostringstream oss(std::stringstream::binary);
+    serialize(person, oss);
+
+    std::istringstream iss(oss.str(), std::stringstream::binary);
+    Person deserialized_person{"Trash data", 0, 0, 0.0, {9}};
+    deserialize(deserialized_person, iss);
+
+    EXPECT_EQ(person, deserialized_person);
+}
+
+TEST(TestFields, FieldsAreWrittenOneAfterAnother)
+{
+    Person person{"Bob", 42, 180, 80.25, {7}};
+
+    std::vector<std::byte> fields_buffer;
+    VectorWriter fields_writer(fields_buffer);
+    serialize(person.name, fields_writer);
+    serialize(person.age, fields_writer);
+    serialize(person.height, fields_writer);
+    serialize(person.weight, fields_writer);
+    serialize(person.scores, fields_writer);
+
+    std::vector<std::byte> buffer;
+    VectorWriter w(buffer);
+    serialize(person, w);
+
+    EXPECT_EQ(buffer, fields_buffer);
+    EXPECT_EQ(serialized_size(person), buffer.size());
+}
+
+TEST(TestFields, PaddingIsNotWritten)
+{
+    Padded padded{'x', 3.5, -7};
+
+    std::vector<std::byte> buffer;
+    VectorWriter w(buffer);
+    serialize(padded, w);
+
+    EXPECT_EQ(buffer.size(), sizeof(char) + sizeof(double) + sizeof(int));
+    EXPECT_LT(buffer.size(), sizeof(Padded));
+    EXPECT_EQ(serialized_size(padded), buffer.size());
+
+    SpanReader r(buffer);
+    Padded deserialized_padded{};
+    deserialize(deserialized_padded, r);
+
+    EXPECT_EQ(padded, deserialized_padded);
+}
+
+TEST(TestFields, ContainersOfStructs)
+{
+    std::vector<Padded> vec = {{'a', 1.0, 1}, {'b', 2.0, 2}, {'c', 3.0, 3}};
+
+    std::vector<std::byte> buffer;
+    VectorWriter w(buffer);
+    serialize(vec, w);
+
+    // Trivially copyable listed structs are not copied as raw blocks with their padding
+    EXPECT_EQ(buffer.size(), sizeof(uint32_t) + vec.size() * (sizeof(char) + sizeof(double) + sizeof(int)));
+
+    SpanReader r(buffer);
+    std::vector<Padded> deserialized_vector{};
+    deserialize(deserialized_vector, r);
+
+    EXPECT_EQ(vec, deserialized_vector);
+}
+
+TEST(TestFields, NestedStructs)
+{
+    Team team;
+    team.title = "Team";
+    team.members["Alice"] = Person{"Alice", 30, 170, 60.5, {1, 2, 3}};
+    team.members["Bob"] = Person{"Bob", 42, 180, 80.25, {}};
+    team.stats = Padded{'t', 0.5, 2};
+
+    std::ostringstream oss(std::stringstream::binary);
+    serialize(team, oss);
+    EXPECT_EQ(serialized_size(team), oss.str().size());
+
+    std::istringstream iss(oss.str(), std::stringstream::binary);
+    Team deserialized_team{};
+    deserialize(deserialized_team, iss);
+
+    EXPECT_EQ(team, deserialized_team);
+}
+
+TEST(TestFields, VarintEncoding)
+{
+    Person person{"Carol", -5, 160, 55.0, {100000, -1}};
+
+    std::vector<std::byte> buffer;
+    VectorWriter inner_writer(buffer);
+    auto w = with_encoding<VarintEncoding>(inner_writer);
+    serialize(person, w);
+    EXPECT_EQ(serialized_size<VarintEncoding>(person), buffer.size());
+
+    SpanReader inner_reader(buffer);
+    auto r = with_decoding<VarintEncoding>(inner_reader);
+    Person deserialized_person{};
+    deserialize(deserialized_person, r);
+
+    EXPECT_EQ(person, deserialized_person);
+}
@@ -0,0 +1,196 @@
+#include <gtest/gtest.h>
+
+#include <iostream>
+#include <cstddef>
+#include <vector>
+#include <map>
+#include <set>
+#include <forward_list>
+#include <string>
+#include "my_vector.hpp"
+
+// #include <serialize_concepts.hpp>
+// #include <serialize_sfinae.hpp>
+#include "serialize.hpp"
+#include "incremental_deserialize.hpp"
+
+
+namespace
+{
+    template <typename T>
+    std::vector<std::byte> to_bytes(const T& obj)
+    {
+        std::vector<std::byte> buffer;
+        VectorWriter w(buffer);
+        serialize(obj, w);
+        return buffer;
+    }
+
+    // Feeds the bytes in fragments of the given size, returns the status after the last one
+    template <typename Decoder>
+    DecodeStatus feed_by_fragments(Decoder& decoder, const std::vector<std::byte>& bytes, std::size_t fragment_size)
+    {
+        DecodeStatus status = DecodeStatus::NeedMore;
+        for (std::size_t i = 0; i < bytes.size(); i += fragment_size)
+        {
+            const std::size_t size = std::min(fragment_size, bytes.size() - i);
+            status = decoder.feed(std::span<const std::byte>(bytes.data() + i, size));
+        }
+        return status;
+    }
+}
+
+
+TEST(TestIncremental, VectorOfStringsByFragments)
+{
+    std::vector<std::string> vec;
+    for (int i = 0; i < 200; ++i)
+        vec.push_back(std::string(i % 17, 'a' + i % 26));
+    const auto bytes = to_bytes(vec);
+
+    for (std::size_t fragment_size : {1u, 3u, 7u, 64u, 100000u})
+    {
+        std::vector<std::string> deserialized_vector = {"Trash data"};
+        IncrementalDeserializer<std::vector<std::string>> decoder(deserialized_vector);
+
+        EXPECT_EQ(feed_by_fragments(decoder, bytes, fragment_size), DecodeStatus::Done);
+        EXPECT_TRUE(decoder.done());
+        EXPECT_EQ(decoder.consumed(), bytes.size());
+        EXPECT_EQ(vec, deserialized_vector);
+    }
+}
+
+TEST(TestIncremental, ProgressIsKeptMidContainer)
+{
+    std::vector<std::string> vec(100, "0123456789");
+    const auto bytes = to_bytes(vec);
+
+    std::vector<std::string> deserialized_vector{};
+    IncrementalDeserializer<std::vector<std::string>> decoder(deserialized_vector);
+
+    // Length, 10 elements and a half of the next one
+    const std::size_t head = sizeof(uint32_t) + 10 * (sizeof(uint32_t) + 10) + 7;
+    EXPECT_EQ(decoder.feed(std::span<const std::byte>(bytes.data(), head)), DecodeStatus::NeedMore);
+    EXPECT_EQ(deserialized_vector.size(), 10u);
+    EXPECT_EQ(decoder.buffered(), 7u);
+
+    EXPECT_EQ(decoder.feed(std::span<const std::byte>(bytes).subspan(head)), DecodeStatus::Done);
+    EXPECT_EQ(vec, deserialized_vector);
+}
+
+TEST(TestIncremental, BufferedBytesAreBounded)
+{
+    std::vector<std::string> vec(10000, std::string(50, 'x'));
+    const auto bytes = to_bytes(vec);
+
+    std::vector<std::string> deserialized_vector{};
+    IncrementalDeserializer<std::vector<std::string>> decoder(deserialized_vector);
+
+    std::size_t max_buffered = 0;
+    for (std::size_t i = 0; i < bytes.size(); i += 128)
+    {
+        decoder.feed(std::span<const std::byte>(bytes).subspan(i, std::min<std::size_t>(128, bytes.size() - i)));
+        max_buffered = std::max(max_buffered, decoder.buffered());
+    }
+
+    EXPECT_TRUE(decoder.done());
+    EXPECT_LT(max_buffered, 128u + sizeof(uint32_t) + 50);
+    EXPECT_EQ(vec, deserialized_vector);
+}
+
+TEST(TestIncremental, AssociativeAndForwardList)
+{
+    std::map<std::string, std::vector<int>> mp = {{"one", {1}}, {"two", {2, 2}}, {"empty", {}}};
+    std::set<long long> st = {-5, 0, 5, 1LL << 40};
+    std::forward_list<std::string> fl = {"first", "second", "third"};
+    MyVector<int> my_vector;
+    for (int i = 0; i < 50; ++i)
+        my_vector.push_back(i * i);
+
+    std::map<std::string, std::vector<int>> deserialized_map = {{"trash", {0}}};
+    IncrementalDeserializer<std::map<std::string, std::vector<int>>> map_decoder(deserialized_map);
+    EXPECT_EQ(feed_by_fragments(map_decoder, to_bytes(mp), 5), DecodeStatus::Done);
+    EXPECT_EQ(mp, deserialized_map);
+
+    std::set<long long> deserialized_set{};
+    IncrementalDeserializer<std::set<long long>> set_decoder(deserialized_set);
+    EXPECT_EQ(feed_by_fragments(set_decoder, to_bytes(st), 3), DecodeStatus::Done);
+    EXPECT_EQ(st, deserialized_set);
+
+    std::forward_list<std::string> deserialized_list = {"trash"};
+    IncrementalDeserializer<std::forward_list<std::string>> list_decoder(deserialized_list);
+    EXPECT_EQ(feed_by_fragments(list_decoder, to_bytes(fl), 2), DecodeStatus::Done);
+    EXPECT_EQ(fl, deserialized_list);
+
+    MyVector<int> deserialized_my_vector;
+    IncrementalDeserializer<MyVector<int>> my_vector_decoder(deserialized_my_vector);
+    EXPECT_EQ(feed_by_fragments(my_vector_decoder, to_bytes(my_vector), 9), DecodeStatus::Done);
+    EXPECT_EQ(my_vector, deserialized_my_vector);
+}
+
+TEST(TestIncremental, ScalarsAndStrings)
+{
+    long long value = -1234567890123LL;
+    long long deserialized_value = 0;
+    IncrementalDeserializer<long long> value_decoder(deserialized_value);
+    EXPECT_EQ(feed_by_fragments(value_decoder, to_bytes(value), 3), DecodeStatus::Done);
+    EXPECT_EQ(value, deserialized_value);
+
+    std::string str(1000, 'q');
+    std::string deserialized_str = "Trash data";
+    IncrementalDeserializer<std::string> str_decoder(deserialized_str);
+    EXPECT_EQ(feed_by_fragments(str_decoder, to_bytes(str), 10), DecodeStatus::Done);
+    EXPECT_EQ(str, deserialized_str);
+}
+
+TEST(TestIncremental, EmptyContainer)
+{
+    std::vector<int> deserialized_vector = {1, 2, 3};
+    IncrementalDeserializer<std::vector<int>> decoder(deserialized_vector);
+
+    EXPECT_EQ(feed_by_fragments(decoder, to_bytes(std::vector<int>{}), 1), DecodeStatus::Done);
+    EXPECT_TRUE(deserialized_vector.empty());
+}
+
+TEST(TestIncremental, VarintEncoding)
+{
+    std::vector<int> vec = {0, -1, 1, 300, -70000, 1 << 30};
+
+    std::vector<std::byte> bytes;
+    VectorWriter inner(bytes);
+    auto w = with_encoding<VarintEncoding>(inner);
+    serialize(vec, w);
+
+    std::vector<int> deserialized_vector{};
+    IncrementalDeserializer<std::vector<int>, VarintEncoding> decoder(deserialized_vector);
+    EXPECT_EQ(feed_by_fragments(decoder, bytes, 1), DecodeStatus::Done);
+    EXPECT_EQ(vec, deserialized_vector);
+}
+
+TEST(TestIncremental, LeftoverBytesOfNextObject)
+{
+    std::vector<std::byte> bytes = to_bytes(std::string("first"));
+    const auto second = to_bytes(std::vector<int>{4, 5, 6});
+    bytes.insert(bytes.end(), second.begin(), second.end());
+
+    std::string first;
+    IncrementalDeserializer<std::string> first_decoder(first);
+    EXPECT_EQ(first_decoder.feed(bytes), DecodeStatus::Done);
+    EXPECT_EQ(first, "first");
+    EXPECT_EQ(first_decoder.leftover().size(), second.size());
+
+    std::vector<int> vec;
+    IncrementalDeserializer<std::vector<int>> second_decoder(vec);
+    EXPECT_EQ(second_decoder.feed(first_decoder.leftover()), DecodeStatus::Done);
+    EXPECT_EQ(vec, std::vector<int>({4, 5, 6}));
+}
+
+TEST(TestIncremental, InvalidVarintThrows)
+{
+    std::vector<std::byte> bytes(11, std::byte{0xFF});
+
+    std::vector<int> vec;
+    IncrementalDeserializer<std::vector<int>, VarintEncoding> decoder(vec);
+
+    EXPECT_THROW(decoder.feed(bytes), SerializeBufferError);
+}
@@ -0,0 +1,215 @@
+#include <gtest/gtest.h>
+
+#include <iostream>
+#include <sstream>
+#include <cstddef>
+#include <cstring>
+#include <cstdio>
+#include <vector>
+#include <map>
+#include <string>
+
+// #include <serialize_concepts.hpp>
+// #include <serialize_sfinae.hpp>
+#include "serialize.hpp"
+#include "indexed_archive.hpp"
+#include "mapped_file_archive.hpp"
+
+
+namespace
+{
+    std::map<std::string, std::vector<int>> make_map(int count)
+    {
+        std::map<std::string, std::vector<int>> mp;
+        for (int i = 0; i < count; ++i)
+            mp["key" + std::to_string(i)] = std::vector<int>(i % 5, i);
+        return mp;
+    }
+}
+
+
+TEST(TestIndexedArchive, SequenceRandomAccess)
+{
+    std::vector<std::string> vec;
+    for (int i = 0; i < 1000; ++i)
+        vec.push_back(std::string(i % 13, 'a') + std::to_string(i));
+
+    std::vector<std::byte> buffer;
+    VectorWriter w(buffer);
+    serialize_indexed(vec, w);
+
+    IndexedArchiveReader archive(buffer);
+    EXPECT_EQ(archive.kind(), IndexedArchiveKind::Sequence);
+    ASSERT_EQ(archive.size(), vec.size());
+
+    for (std::size_t i : {999u, 0u, 500u, 1u, 998u})
+    {
+        std::string element;
+        archive.read(i, element);
+        EXPECT_EQ(element, vec[i]);
+    }
+}
+
+TEST(TestIndexedArchive, MapFindByKey)
+{
+    const auto mp = make_map(1000);
+
+    std::ostringstream oss(std::stringstream::binary);
+    StreamWriter w(oss);
+    serialize_indexed(mp, w);
+    const std::string bytes = oss.str();
+
+    IndexedArchiveReader archive(std::span<const std::byte>(reinterpret_cast<const std::byte*>(bytes.data()), bytes.size()));
+    EXPECT_EQ(archive.kind(), IndexedArchiveKind::Map);
+    ASSERT_EQ(archive.size(), mp.size());
+
+    for (const auto& [key, value] : mp)
+    {
+        std::vector<int> found_value{-1};
+        EXPECT_TRUE(archive.find(key, found_value));
+        EXPECT_EQ(found_value, value);
+    }
+
+    std::vector<int> missing_value;
+    EXPECT_FALSE(archive.find(std::string("key"), missing_value));
+    EXPECT_FALSE(archive.find(std::string("zzz"), missing_value));
+    EXPECT_FALSE(archive.find(std::string("key5000"), missing_value));
+
+    std::string key;
+    std::vector<int> value;
+    archive.read(0, key, value);
+    EXPECT_EQ(key, mp.begin()->first);
+    EXPECT_EQ(value, mp.begin()->second);
+}
+
+TEST(TestIndexedArchive, EncodingIsStoredInHeader)
+{
+    std::map<long long, long long> mp;
+    for (long long i = -100; i < 100; ++i)
+        mp[i * 1000] = -i;
+
+    std::vector<std::byte> buffer;
+    VectorWriter inner_writer(buffer);
+    auto w = with_encoding<VarintEncoding>(inner_writer);
+    serialize_indexed(mp, w);
+
+    IndexedArchiveReader archive(buffer);
+    EXPECT_TRUE(archive.varint());
+
+    long long value = 0;
+    EXPECT_TRUE(archive.find<long long>(-42000, value));
+    EXPECT_EQ(value, 42);
+    EXPECT_FALSE(archive.find<long long>(1, value));
+}
+
+TEST(TestIndexedArchive, FindConvertsTheKey)
+{
+    const auto mp = make_map(100);
+
+    std::vector<std::byte> buffer;
+    VectorWriter w(buffer);
+    serialize_indexed(mp, w);
+
+    // The stored keys are std::string by default, a string literal is converted to it
+    IndexedArchiveReader archive(buffer);
+    std::vector<int> value;
+    EXPECT_TRUE(archive.find("key42", value));
+    EXPECT_EQ(value, mp.at("key42"));
+    EXPECT_FALSE(archive.find("key420", value));
+}
+
+TEST(TestIndexedArchive, ByteOrderOfTheArchive)
+{
+    std::map<int, double> mp = {{-1, 0.5}, {7, -2.25}, {1 << 20, 1e100}};
+
+    std::vector<std::byte> buffer;
+    VectorWriter inner_writer(buffer);
+    auto w = with_encoding<BigEndianEncoding>(inner_writer);
+    serialize_indexed(mp, w);
+
+    // The header and the footer are little-endian on every host, the body has the byte order of the encoding
+    EXPECT_EQ(buffer[4], std::byte{1});
+    EXPECT_EQ(buffer[5], std::byte{0});
+    EXPECT_EQ(buffer[8], std::byte{0xff});
+    EXPECT_EQ(buffer[11], std::byte{0xff});
+    EXPECT_EQ(buffer[buffer.size() - 12], std::byte{3});
+
+    IndexedArchiveReader archive(buffer);
+    EXPECT_TRUE(archive.big_endian());
+    EXPECT_FALSE(archive.varint());
+
+    double value = 0;
+    EXPECT_TRUE(archive.find<int>(7, value));
+    EXPECT_EQ(value, -2.25);
+    EXPECT_TRUE(archive.find<int>(1 << 20, value));
+    EXPECT_EQ(value, 1e100);
+
+    int key = 0;
+    archive.read(0, key, value);
+    EXPECT_EQ(key, -1);
+    EXPECT_EQ(value, 0.5);
+}
+
+TEST(TestIndexedArchive, EmptyContainer)
+{
+    std::vector<int> vec{};
+
+    std::vector<std::byte> buffer;
+    VectorWriter w(buffer);
+    serialize_indexed(vec, w);
+
+    IndexedArchiveReader archive(buffer);
+    EXPECT_TRUE(archive.empty());
+
+    int element = 0;
+    EXPECT_THROW(archive.read(0, element), IndexedArchiveError);
+}
+
+TEST(TestIndexedArchive, InvalidArchivesThrow)
+{
+    std::vector<std::byte> buffer;
+    VectorWriter w(buffer);
+    serialize_indexed(std::vector<int>{1, 2, 3}, w);
+
+    auto wrong_magic = buffer;
+    wrong_magic[0] = std::byte{'X'};
+    EXPECT_THROW(IndexedArchiveReader{wrong_magic}, IndexedArchiveError);
+
+    auto newer_version = buffer;
+    newer_version[4] = std::byte{2};
+    EXPECT_THROW(IndexedArchiveReader{newer_version}, IndexedArchiveError);
+
+    auto truncated = buffer;
+    truncated.erase(truncated.begin() + 10);
+    EXPECT_THROW(IndexedArchiveReader{truncated}, IndexedArchiveError);
+
+    EXPECT_THROW(IndexedArchiveReader(std::span<const std::byte>(buffer.data(), 5)), IndexedArchiveError);
+
+    IndexedArchiveReader archive(buffer);
+    int value = 0;
+    EXPECT_THROW(archive.find<int>(1, value), IndexedArchiveError);
+    EXPECT_THROW(archive.read(3, value), IndexedArchiveError);
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+TEST(TestIndexedArchive, MappedFile)
+{
+    const std::string filename = "test_indexed_archive.ser";
+    const auto mp = make_map(100);
+    {
+        MappedFileWriter w(filename);
+        serialize_indexed(mp, w);
+    }
+
+    {
+        MappedFileReader r(filename);
+        IndexedArchiveReader archive(r.bytes());
+
+        std::vector<int> value;
+        EXPECT_TRUE(archive.find(std::string("key42"), value));
+        EXPECT_EQ(value, mp.at("key42"));
+    }
+
+    std::remove(filename.c_str());
+}
+#endif
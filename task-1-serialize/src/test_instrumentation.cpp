@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <map>
+#include <string>
+#include <string_view>
+#include <new>
+#include <limits>
+
+// #include <serialize_concepts.hpp>
+// #include <serialize_sfinae.hpp>
+#include "serialize.hpp"
+#include "serialize_instrumentation.hpp"
+
+
+namespace
+{
+    // Long enough not to fit into the small string buffer
+    std::string long_string(int i)
+    {
+        return "a string that doesn't fit into SSO, number " + std::to_string(i);
+    }
+
+    // Keeps the compiler from removing a new / delete pair whose result is unused
+    std::vector<int>* volatile g_escaped = nullptr;
+
+    int g_new_handler_calls = 0;
+}
+
+
+TEST(TestInstrumentation, CountsAllocations)
+{
+    ScopedSerializeCounters scope;
+    g_escaped = new std::vector<int>(100);
+    const SerializeCounters c = scope.counters();
+    delete g_escaped;
+
+    EXPECT_EQ(c.allocations, 2u);
+    EXPECT_GE(c.allocated_bytes, sizeof(std::vector<int>) + 100 * sizeof(int));
+}
+
+TEST(TestInstrumentation, NestedScopes)
+{
+    ScopedSerializeCounters outer;
+    std::string first = long_string(1);
+
+    ScopedSerializeCounters inner;
+    std::string second = long_string(2);
+    const SerializeCounters inner_c = inner.counters();
+    const SerializeCounters outer_c = outer.counters();
+
+    EXPECT_EQ(inner_c.allocations, 1u);
+    EXPECT_EQ(outer_c.allocations, 2u);
+}
+
+TEST(TestInstrumentation, NewHandlerIsCalledBeforeBadAlloc)
+{
+    // The handler can't free anything, so it removes itself and the next try throws
+    g_new_handler_calls = 0;
+    const std::new_handler previous = std::set_new_handler([] {
+        ++g_new_handler_calls;
+        std::set_new_handler(nullptr);
+    });
+
+    volatile std::size_t too_large = std::numeric_limits<std::size_t>::max() / 2;
+    EXPECT_THROW(::operator delete(::operator new(too_large)), std::bad_alloc);
+    EXPECT_EQ(g_new_handler_calls, 1);
+
+    std::set_new_handler(previous);
+}
+
+TEST(TestInstrumentation, SerializeIntoReservedBufferDoesNotAllocate)
+{
+    const std::vector<int> vec(1000, 7);
+
+    std::vector<std::byte> buffer;
+    buffer.reserve(serialized_size(vec));
+    VectorWriter w(buffer);
+    const SerializeCounters c = counted_serialize(vec, w);
+
+    EXPECT_EQ(c.allocations, 0u);
+    EXPECT_EQ(c.bytes_copied, serialized_size(vec));
+    EXPECT_EQ(c.stream_calls, 2u);
+}
+
+TEST(TestInstrumentation, DeserializeTriviallyCopyableVector)
+{
+    const std::vector<uint64_t> vec(1000, 42);
+    std::vector<std::byte> buffer;
+    VectorWriter w(buffer);
+    serialize(vec, w);
+
+    std::vector<uint64_t> result;
+    SpanReader r(buffer);
+    const SerializeCounters c = counted_deserialize(result, r);
+
+    EXPECT_EQ(result, vec);
+    EXPECT_EQ(c.allocations, 1u);
+    EXPECT_EQ(c.bytes_copied, buffer.size());
+    EXPECT_EQ(c.stream_calls, 2u);
+}
+
+TEST(TestInstrumentation, DeserializeNestedContainer)
+{
+    std::map<std::string, std::vector<std::string>> m;
+    for (int i = 0; i < 10; ++i)
+        for (int j = 0; j < 5; ++j)
+            m[long_string(i)].push_back(long_string(j));
+
+    std::vector<std::byte> buffer;
+    VectorWriter w(buffer);
+    serialize(m, w);
+
+    std::map<std::string, std::vector<std::string>> result;
+    SpanReader r(buffer);
+    const SerializeCounters c = counted_deserialize(result, r);
+
+    // Per key: the map node, the key, the vector block and 5 strings
+    EXPECT_EQ(result, m);
+    EXPECT_EQ(c.allocations, 10u * (3 + 5));
+    EXPECT_EQ(c.bytes_copied, buffer.size());
+}
+
+TEST(TestInstrumentation, ViewsAreNotCopied)
+{
+    const std::string str = long_string(0);
+    std::vector<std::byte> buffer;
+    VectorWriter w(buffer);
+    serialize(str, w);
+
+    std::string_view view;
+    SpanReader r(buffer);
+    const SerializeCounters c = counted_deserialize(view, r);
+
+    EXPECT_EQ(view, str);
+    EXPECT_EQ(c.allocations, 0u);
+    EXPECT_EQ(c.bytes_copied, sizeof(uint32_t));
+    EXPECT_EQ(c.stream_calls, 2u);
+}
+
+TEST(TestInstrumentation, Streams)
+{
+    const std::vector<std::string> vec = {long_string(0), long_string(1), long_string(2)};
+
+    std::stringstream ss(std::stringstream::in | std::stringstream::out | std::stringstream::binary);
+    const SerializeCounters written = counted_serialize(vec, ss);
+    EXPECT_EQ(written.bytes_copied, serialized_size(vec));
+    EXPECT_EQ(written.stream_calls, 1u + 2 * vec.size());
+
+    std::vector<std::string> result;
+    const SerializeCounters read = counted_deserialize(result, ss);
+    EXPECT_EQ(result, vec);
+    EXPECT_EQ(read.bytes_copied, serialized_size(vec));
+    EXPECT_EQ(read.allocations, 1u + vec.size());
+}
@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+
+#include <iostream>
+#include <fstream>
+#include <cstdio>
+#include <vector>
+#include <map>
+#include <string>
+#include <string_view>
+
+// #include <serialize_concepts.hpp>
+// #include <serialize_sfinae.hpp>
+#include "serialize.hpp"
+#include "mapped_file_archive.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+
+TEST(TestMappedFile, MapRoundTrip)
+{
+    std::map<std::string, std::vector<int>> m;
+    for (int i = 0; i < 1000; ++i)
+        m.emplace("key_" + std::to_string(i), std::vector<int>(i % 10, i));
+
+    const std::string filename = "test_mapped_map.ser";
+    {
+        MappedFileWriter w(filename);
+        serialize(m, w);
+        EXPECT_EQ(w.position(), serialized_size(m));
+    }
+
+    std::map<std::string, std::vector<int>> deserialized_m{};
+    {
+        MappedFileReader r(filename);
+        deserialize(deserialized_m, r);
+        EXPECT_EQ(r.remaining(), 0u);
+    }
+
+    std::remove(filename.c_str());
+
+    EXPECT_EQ(m, deserialized_m);
+}
+
+TEST(TestMappedFile, GrowsInSmallChunks)
+{
+    std::vector<std::string> vec;
+    for (int i = 0; i < 500; ++i)
+        vec.push_back(std::string(i, 'a' + i % 26));
+
+    const std::string filename = "test_mapped_grow.ser";
+    {
+        // A tiny chunk size forces many remaps
+        MappedFileWriter w(filename, 64);
+        serialize(vec, w);
+    }
+
+    std::vector<std::string> deserialized_vector{};
+    {
+        MappedFileReader r(filename);
+        EXPECT_EQ(r.bytes().size(), serialized_size(vec));
+        deserialize(deserialized_vector, r);
+    }
+
+    std::remove(filename.c_str());
+
+    EXPECT_EQ(vec, deserialized_vector);
+}
+
+TEST(TestMappedFile, CompatibleWithStreams)
+{
+    std::map<int, std::string> m = {{1, "one"}, {2, "two"}, {3, ""}};
+
+    const std::string filename = "test_mapped_stream.ser";
+    {
+        std::ofstream ofs(filename, std::ofstream::out | std::ofstream::binary);
+        ASSERT_TRUE(ofs.is_open());
+        serialize(m, ofs);
+    }
+
+    std::map<int, std::string> deserialized_m{};
+    {
+        MappedFileReader r(filename);
+        deserialize(deserialized_m, r);
+    }
+
+    std::remove(filename.c_str());
+
+    EXPECT_EQ(m, deserialized_m);
+}
+
+TEST(TestMappedFile, ViewsIntoMapping)
+{
+    const std::string filename = "test_mapped_views.ser";
+    {
+        MappedFileWriter w(filename);
+        serialize(std::string("mapped string"), w);
+    }
+
+    {
+        MappedFileReader r(filename);
+        std::string_view view{};
+        deserialize(view, r);
+
+        EXPECT_EQ(view, "mapped string");
+        EXPECT_EQ(reinterpret_cast<const std::byte*>(view.data()), r.bytes().data() + sizeof(uint32_t));
+    }
+
+    std::remove(filename.c_str());
+}
+
+TEST(TestMappedFile, EmptyFile)
+{
+    const std::string filename = "test_mapped_empty.ser";
+    {
+        MappedFileWriter w(filename);
+    }
+
+    {
+        MappedFileReader r(filename);
+        EXPECT_EQ(r.remaining(), 0u);
+
+        int value = 0;
+        EXPECT_THROW(deserialize(value, r), SerializeBufferError);
+    }
+
+    std::remove(filename.c_str());
+}
+
+TEST(TestMappedFile, WriteAfterCloseThrows)
+{
+    const std::string filename = "test_mapped_closed.ser";
+    {
+        MappedFileWriter w(filename);
+        serialize(42, w);
+        w.close();
+
+        EXPECT_THROW(serialize(43, w), SerializeBufferError);
+        EXPECT_EQ(w.position(), sizeof(int));
+    }
+
+    {
+        MappedFileReader r(filename);
+        int value = 0;
+        deserialize(value, r);
+        EXPECT_EQ(value, 42);
+        EXPECT_EQ(r.remaining(), 0u);
+    }
+
+    std::remove(filename.c_str());
+}
+
+TEST(TestMappedFile, MissingFileThrows)
+{
+    EXPECT_THROW(MappedFileReader r("this_file_does_not_exist.ser"), MappedFileError);
+}
+
+#endif
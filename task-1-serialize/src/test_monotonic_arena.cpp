@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <string>
+#include <memory_resource>
+
+// #include <serialize_concepts.hpp>
+// #include <serialize_sfinae.hpp>
+#include "serialize.hpp"
+#include "serialize_instrumentation.hpp"
+#include "my_vector.hpp"
+#include "monotonic_arena.hpp"
+
+
+TEST(TestMonotonicArena, AlignsAndGrows)
+{
+    MonotonicArena arena(256);
+
+    void* small = arena.allocate(3, 1);
+    void* aligned = arena.allocate(100, 64);
+    EXPECT_NE(small, nullptr);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(aligned) % 64, 0u);
+    EXPECT_EQ(arena.chunk_count(), 1u);
+
+    // Larger than the next chunk
+    void* large = arena.allocate(10'000, 8);
+    EXPECT_NE(large, nullptr);
+    EXPECT_EQ(arena.chunk_count(), 2u);
+    EXPECT_EQ(arena.allocated_bytes(), 10'103u);
+
+    arena.deallocate(large, 10'000, 8);
+    arena.release();
+    EXPECT_EQ(arena.chunk_count(), 0u);
+    EXPECT_EQ(arena.allocated_bytes(), 0u);
+}
+
+TEST(TestMonotonicArena, NestedVectorsUseTheArena)
+{
+    MonotonicArena arena;
+    PmrMyVector<PmrMyVector<int>> vectors(&arena);
+    for (int i = 0; i < 100; ++i)
+    {
+        vectors.emplace_back();
+        for (int j = 0; j < i % 10; ++j)
+            vectors.back().push_back(j);
+    }
+
+    // The inner vectors got the resource of the outer one
+    EXPECT_EQ(vectors[5].get_allocator().resource(), &arena);
+    EXPECT_EQ(vectors[99].size(), 9u);
+    EXPECT_GT(arena.allocated_bytes(), 100 * sizeof(int));
+}
+
+TEST(TestMonotonicArena, EmplaceInTheMiddleUsesTheArena)
+{
+    MonotonicArena arena;
+    PmrMyVector<PmrMyVector<int>> vectors(&arena);
+    vectors.reserve(4);
+    vectors.emplace_back(2, 1);
+    vectors.emplace_back(2, 3);
+
+    // Any allocation outside the arena fails
+    std::pmr::memory_resource* previous = std::pmr::set_default_resource(std::pmr::null_memory_resource());
+    EXPECT_NO_THROW(vectors.emplace(vectors.begin() + 1, std::size_t{3}, 2));
+    std::pmr::set_default_resource(previous);
+
+    ASSERT_EQ(vectors.size(), 3u);
+    EXPECT_EQ(vectors[1], PmrMyVector<int>({2, 2, 2}));
+    EXPECT_EQ(vectors[2], PmrMyVector<int>({3, 3}));
+    EXPECT_EQ(vectors[1].get_allocator().resource(), &arena);
+}
+
+TEST(TestMonotonicArena, DeserializeIntoArena)
+{
+    std::vector<std::vector<int>> source(1000);
+    for (std::size_t i = 0; i < source.size(); ++i)
+        for (std::size_t j = 0; j < i % 16; ++j)
+            source[i].push_back(static_cast<int>(i * j));
+
+    std::vector<std::byte> buffer;
+    VectorWriter w(buffer);
+    serialize(source, w);
+
+    MonotonicArena arena;
+    PmrMyVector<PmrMyVector<int>> result(&arena);
+    SpanReader r(buffer);
+    const SerializeCounters c = counted_deserialize(result, r);
+
+    // The heap is only asked for the chunks of the arena
+    EXPECT_EQ(c.allocations, arena.chunk_count());
+    ASSERT_EQ(result.size(), source.size());
+    for (std::size_t i = 0; i < source.size(); ++i)
+        EXPECT_TRUE(std::equal(result[i].begin(), result[i].end(), source[i].begin(), source[i].end()));
+}
+
+TEST(TestMonotonicArena, SameFormatAsHeapVector)
+{
+    MonotonicArena arena;
+    PmrMyVector<std::pmr::string> pmr_vector(&arena);
+    MyVector<std::string> heap_vector;
+    for (int i = 0; i < 50; ++i)
+    {
+        pmr_vector.emplace_back("a string that doesn't fit into SSO, number " + std::to_string(i));
+        heap_vector.emplace_back("a string that doesn't fit into SSO, number " + std::to_string(i));
+    }
+
+    std::vector<std::byte> pmr_buffer;
+    std::vector<std::byte> heap_buffer;
+    VectorWriter pmr_w(pmr_buffer);
+    VectorWriter heap_w(heap_buffer);
+    serialize(pmr_vector, pmr_w);
+    serialize(heap_vector, heap_w);
+    EXPECT_EQ(pmr_buffer, heap_buffer);
+
+    PmrMyVector<std::pmr::string> result(&arena);
+    SpanReader r(pmr_buffer);
+    deserialize(result, r);
+    EXPECT_EQ(result, pmr_vector);
+    EXPECT_EQ(result[0].get_allocator().resource(), &arena);
+}
+
+TEST(TestMonotonicArena, MoveBetweenResources)
+{
+    MonotonicArena first;
+    MonotonicArena second;
+    PmrMyVector<int> a({1, 2, 3}, &first);
+    PmrMyVector<int> b(&second);
+
+    // Different resources: the elements are moved into the memory of b
+    b = std::move(a);
+    EXPECT_EQ(b, PmrMyVector<int>({1, 2, 3}));
+    EXPECT_EQ(b.get_allocator().resource(), &second);
+    EXPECT_GT(second.allocated_bytes(), 0u);
+
+    // The same resource: the buffer is taken
+    PmrMyVector<int> c(&second);
+    const int* data = b.data();
+    c = std::move(b);
+    EXPECT_EQ(c.data(), data);
+}
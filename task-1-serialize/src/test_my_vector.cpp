@@ -2,11 +2,86 @@
 
 #include <iostream>
 #include <fstream>
+#include <sstream>
+#include <string>
+#include <stdexcept>
+#include <vector>
+#include <list>
+#include <iterator>
+#include <algorithm>
+#include <cstdint>
 #include "my_vector.hpp"
 
 // #include <serialize_concepts.hpp>
 // #include <serialize_sfinae.hpp>
 #include "serialize.hpp"
+#include "serialize_instrumentation.hpp"
+
+
+namespace
+{
+    // Counts its copies and moves, the move may be declared noexcept or not
+    template <bool NothrowMove>
+    struct CountingValue
+    {
+        static inline int copies = 0;
+        static inline int moves = 0;
+
+        int value = 0;
+
+        CountingValue(int v) : value(v) {}
+        CountingValue(const CountingValue& other) : value(other.value) { ++copies; }
+        CountingValue(CountingValue&& other) noexcept(NothrowMove) : value(other.value) { ++moves; }
+        CountingValue& operator=(const CountingValue&) = default;
+        CountingValue& operator=(CountingValue&&) = default;
+
+        static void reset() { copies = 0; moves = 0; }
+    };
+
+    // A stateful standard allocator that counts the live allocations it made
+    template <typename T>
+    struct CountingAllocator
+    {
+        using value_type = T;
+
+        int* live = nullptr;
+
+        explicit CountingAllocator(int* counter) : live(counter) {}
+        template <typename U>
+        CountingAllocator(const CountingAllocator<U>& other) : live(other.live) {}
+
+        T* allocate(std::size_t n)
+        {
+            ++*live;
+            return std::allocator<T>().allocate(n);
+        }
+
+        void deallocate(T* ptr, std::size_t n)
+        {
+            --*live;
+            std::allocator<T>().deallocate(ptr, n);
+        }
+
+        template <typename U>
+        bool operator==(const CountingAllocator<U>& other) const { return live == other.live; }
+    };
+
+    // Its copy constructor throws on the given value
+    struct ThrowingCopy
+    {
+        static inline int throw_on = -1;
+
+        int value = 0;
+
+        ThrowingCopy(int v) : value(v) {}
+        ThrowingCopy(const ThrowingCopy& other) : value(other.value)
+        {
+            if (value == throw_on) throw std::runtime_error("copy failed");
+        }
+        ThrowingCopy(ThrowingCopy&& other) noexcept(false) : ThrowingCopy(static_cast<const ThrowingCopy&>(other)) {}
+    };
+}
+
 
 TEST(TestMyCustomVector, EmptyIntVector)
 {
@@ -150,3 +225,349 @@ TEST(TestMyCustomVector, ReuseAfterClear)
     EXPECT_EQ(restored[0], 10);
     EXPECT_EQ(restored[1], 20);
 }
+
+TEST(TestMyCustomVector, BulkWriteHasSameFormat)
+{
+    MyVector<int> my_vector;
+    std::vector<int> std_vector;
+    for (int i = 0; i < 1000; ++i)
+    {
+        my_vector.push_back(i * 3 - 500);
+        std_vector.push_back(i * 3 - 500);
+    }
+
+    std::ostringstream my_oss(std::stringstream::binary);
+    std::ostringstream std_oss(std::stringstream::binary);
+
+    serialize(my_vector, my_oss);
+    serialize(std_vector, std_oss);
+
+    EXPECT_EQ(my_oss.str(), std_oss.str());
+
+    std::istringstream iss(my_oss.str(), std::stringstream::binary);
+    iss >> std::noskipws;
+
+    MyVector<int> deserialized_vector{};
+
+    deserialize(deserialized_vector, iss);
+
+    EXPECT_EQ(my_vector, deserialized_vector);
+}
+
+TEST(TestMyCustomVector, ReserveMovesNothrowMovableElements)
+{
+    using Value = CountingValue<true>;
+
+    MyVector<Value> vector;
+    vector.reserve(4);
+    for (int i = 0; i < 4; ++i)
+        vector.push_back(Value(i));
+
+    Value::reset();
+    vector.reserve(100);
+
+    EXPECT_EQ(Value::copies, 0);
+    EXPECT_EQ(Value::moves, 4);
+    for (int i = 0; i < 4; ++i)
+        EXPECT_EQ(vector[i].value, i);
+}
+
+TEST(TestMyCustomVector, ReserveCopiesWhenMoveMayThrow)
+{
+    using Value = CountingValue<false>;
+
+    MyVector<Value> vector;
+    vector.reserve(4);
+    for (int i = 0; i < 4; ++i)
+        vector.push_back(Value(i));
+
+    Value::reset();
+    vector.reserve(100);
+
+    EXPECT_EQ(Value::copies, 4);
+    EXPECT_EQ(Value::moves, 0);
+}
+
+TEST(TestMyCustomVector, ReserveKeepsElementsWhenCopyThrows)
+{
+    MyVector<ThrowingCopy> vector;
+    vector.reserve(4);
+    for (int i = 0; i < 4; ++i)
+        vector.push_back(ThrowingCopy(i));
+
+    ThrowingCopy::throw_on = 2;
+    EXPECT_THROW(vector.reserve(100), std::runtime_error);
+    ThrowingCopy::throw_on = -1;
+
+    EXPECT_EQ(vector.capacity(), 4u);
+    ASSERT_EQ(vector.size(), 4u);
+    for (int i = 0; i < 4; ++i)
+        EXPECT_EQ(vector[i].value, i);
+}
+
+TEST(TestMyCustomVector, GrowthKeepsStrings)
+{
+    MyVector<std::string> vector;
+    for (int i = 0; i < 1000; ++i)
+        vector.push_back("a string that doesn't fit into SSO, number " + std::to_string(i));
+
+    // The pushed value is an element of the vector that is about to grow
+    while (vector.size() != vector.capacity())
+        vector.push_back(std::string("filler"));
+    vector.push_back(vector[0]);
+
+    EXPECT_EQ(vector[vector.size() - 1], vector[0]);
+    for (int i = 0; i < 1000; ++i)
+        EXPECT_EQ(vector[i], "a string that doesn't fit into SSO, number " + std::to_string(i));
+}
+
+TEST(TestMyCustomVector, EmplaceBackAndAccess)
+{
+    MyVector<std::pair<int, std::string>> vector;
+    EXPECT_TRUE(vector.empty());
+
+    vector.emplace_back(1, "one");
+    std::pair<int, std::string>& second = vector.emplace_back(2, "two");
+    EXPECT_EQ(second.second, "two");
+
+    EXPECT_EQ(vector.size(), 2u);
+    EXPECT_EQ(vector.front().first, 1);
+    EXPECT_EQ(vector.back().second, "two");
+    EXPECT_EQ(vector.at(1).first, 2);
+    EXPECT_THROW(vector.at(2), std::out_of_range);
+
+    vector.pop_back();
+    EXPECT_EQ(vector.size(), 1u);
+    EXPECT_EQ(vector.data()->second, "one");
+}
+
+TEST(TestMyCustomVector, InsertSingleElements)
+{
+    MyVector<std::string> vector = {"a", "c", "e"};
+    vector.reserve(10);
+
+    // In place and with growth
+    vector.insert(vector.begin() + 1, "b");
+    vector.insert(vector.begin() + 3, std::string("d"));
+    vector.emplace(vector.end(), "f");
+    vector.insert(vector.begin(), vector[5]);
+
+    const MyVector<std::string> expected = {"f", "a", "b", "c", "d", "e", "f"};
+    EXPECT_EQ(vector, expected);
+
+    MyVector<std::string> full = {"x", "y"};
+    full.shrink_to_fit();
+    full.insert(full.begin(), full[1]);
+    EXPECT_EQ(full, MyVector<std::string>({"y", "x", "y"}));
+}
+
+TEST(TestMyCustomVector, InsertRanges)
+{
+    const std::vector<int> source = {10, 11, 12, 13, 14};
+
+    // Every position and every length, both when the range fits and when the buffer grows
+    for (std::size_t capacity : {8u, 64u})
+        for (std::size_t index = 0; index <= 4; ++index)
+            for (std::size_t count = 0; count <= source.size(); ++count)
+            {
+                MyVector<std::string> vector;
+                std::vector<std::string> expected;
+                vector.reserve(capacity);
+                for (int i = 0; i < 4; ++i)
+                {
+                    vector.push_back(std::to_string(i));
+                    expected.push_back(std::to_string(i));
+                }
+
+                std::list<std::string> range;
+                for (std::size_t i = 0; i < count; ++i)
+                    range.push_back(std::to_string(source[i]));
+
+                auto it = vector.insert(vector.begin() + index, range.begin(), range.end());
+                expected.insert(expected.begin() + index, range.begin(), range.end());
+
+                EXPECT_EQ(it, vector.begin() + index);
+                EXPECT_TRUE(std::equal(vector.begin(), vector.end(), expected.begin(), expected.end()))
+                    << "capacity " << capacity << ", index " << index << ", count " << count;
+            }
+}
+
+TEST(TestMyCustomVector, InsertForwardRangeGrowsOnce)
+{
+    MyVector<int> vector = {1, 2, 3};
+    vector.shrink_to_fit();
+    const std::vector<int> range(1000, 7);
+
+    ScopedSerializeCounters scope;
+    vector.insert(vector.begin() + 1, range.begin(), range.end());
+    const SerializeCounters c = scope.counters();
+
+    EXPECT_EQ(c.allocations, 1u);
+    EXPECT_EQ(vector.size(), 1003u);
+    EXPECT_EQ(vector[0], 1);
+    EXPECT_EQ(vector[1000], 7);
+    EXPECT_EQ(vector[1001], 2);
+}
+
+TEST(TestMyCustomVector, InsertInputRangeAndCount)
+{
+    std::istringstream iss("4 5 6");
+    MyVector<int> vector = {1, 2, 3};
+    vector.insert(vector.begin() + 1, std::istream_iterator<int>(iss), std::istream_iterator<int>());
+    EXPECT_EQ(vector, MyVector<int>({1, 4, 5, 6, 2, 3}));
+
+    vector.insert(vector.end() - 1, 3, 0);
+    EXPECT_EQ(vector, MyVector<int>({1, 4, 5, 6, 2, 0, 0, 0, 3}));
+
+    MyVector<int> counted(3, 9);
+    EXPECT_EQ(counted, MyVector<int>({9, 9, 9}));
+}
+
+TEST(TestMyCustomVector, Erase)
+{
+    MyVector<std::string> vector = {"a", "b", "c", "d", "e"};
+
+    auto it = vector.erase(vector.begin() + 1);
+    EXPECT_EQ(*it, "c");
+    it = vector.erase(vector.begin() + 1, vector.begin() + 3);
+    EXPECT_EQ(*it, "e");
+    EXPECT_EQ(vector, MyVector<std::string>({"a", "e"}));
+
+    vector.erase(vector.begin(), vector.end());
+    EXPECT_TRUE(vector.empty());
+}
+
+TEST(TestMyCustomVector, ResizeAndShrinkToFit)
+{
+    MyVector<int> vector;
+    vector.resize(5);
+    EXPECT_EQ(vector, MyVector<int>({0, 0, 0, 0, 0}));
+
+    vector.resize(7, 3);
+    EXPECT_EQ(vector, MyVector<int>({0, 0, 0, 0, 0, 3, 3}));
+
+    vector.resize(2);
+    EXPECT_EQ(vector, MyVector<int>({0, 0}));
+    EXPECT_GE(vector.capacity(), 7u);
+
+    vector.shrink_to_fit();
+    EXPECT_EQ(vector.capacity(), 2u);
+    EXPECT_EQ(vector, MyVector<int>({0, 0}));
+
+    vector.clear();
+    vector.shrink_to_fit();
+    EXPECT_EQ(vector.capacity(), 0u);
+}
+
+TEST(TestMyCustomVector, DeserializeAllocatesOnce)
+{
+    MyVector<uint64_t> numbers(1000, 42);
+    MyVector<std::string> strings;
+    for (int i = 0; i < 100; ++i)
+        strings.push_back("a string that doesn't fit into SSO, number " + std::to_string(i));
+
+    std::vector<std::byte> buffer;
+    VectorWriter w(buffer);
+    serialize(numbers, w);
+    serialize(strings, w);
+
+    MyVector<uint64_t> deserialized_numbers;
+    MyVector<std::string> deserialized_strings;
+    SpanReader r(buffer);
+
+    // One block for the numbers, one block and the characters of every string for the strings
+    EXPECT_EQ(counted_deserialize(deserialized_numbers, r).allocations, 1u);
+    EXPECT_EQ(counted_deserialize(deserialized_strings, r).allocations, 1u + strings.size());
+    EXPECT_EQ(deserialized_numbers, numbers);
+    EXPECT_EQ(deserialized_strings, strings);
+}
+
+TEST(TestMyCustomVector, StandardAllocator)
+{
+    int live = 0;
+    {
+        CountingAllocator<std::string> alloc(&live);
+        MyVector<std::string, CountingAllocator<std::string>> vector(alloc);
+        for (int i = 0; i < 100; ++i)
+            vector.push_back(std::to_string(i));
+        EXPECT_EQ(live, 1);
+
+        // The copy keeps the allocator, so it allocates from the same counter
+        MyVector<std::string, CountingAllocator<std::string>> copy(vector);
+        EXPECT_EQ(live, 2);
+        EXPECT_EQ(copy, vector);
+
+        std::ostringstream oss(std::stringstream::binary);
+        serialize(vector, oss);
+        std::istringstream iss(oss.str(), std::stringstream::binary);
+        MyVector<std::string, CountingAllocator<std::string>> deserialized_vector(alloc);
+        deserialize(deserialized_vector, iss);
+        EXPECT_EQ(deserialized_vector, vector);
+        EXPECT_EQ(live, 3);
+    }
+    EXPECT_EQ(live, 0);
+}
+
+namespace
+{
+    enum class Color : uint16_t { Red, Green, Blue };
+
+    // Every length around the 32-byte blocks, the value at every position and nowhere
+    template <typename T>
+    void check_search(T present, T absent)
+    {
+        for (std::size_t length = 0; length <= 80; ++length)
+        {
+            MyVector<T> vector(length, absent);
+            EXPECT_EQ(vector.find(present), vector.end());
+            EXPECT_EQ(vector.count(absent), length);
+            EXPECT_FALSE(vector.contains(present));
+
+            for (std::size_t position = 0; position < length; ++position)
+            {
+                vector[position] = present;
+                EXPECT_EQ(vector.find(present), vector.begin() + position);
+                EXPECT_TRUE(vector.contains(present));
+                EXPECT_EQ(vector.count(present), 1u);
+                EXPECT_EQ(vector.count(absent), length - 1);
+                vector[position] = absent;
+            }
+
+            // Every other value
+            for (std::size_t position = 0; position < length; position += 2)
+                vector[position] = present;
+            EXPECT_EQ(vector.count(present), (length + 1) / 2);
+        }
+    }
+}
+
+TEST(TestMyCustomVector, FindCountContains)
+{
+    check_search<uint8_t>(0xFF, 1);
+    check_search<int16_t>(-1, 0x00FF);
+    check_search<uint32_t>(0x80000001u, 0x00000001u);
+    check_search<int64_t>(-2, 0x7FFFFFFFFFFFFFFE);
+    check_search<Color>(Color::Blue, Color::Green);
+
+    int a = 0;
+    int b = 0;
+    check_search<int*>(&a, &b);
+
+    MyVector<std::string> strings = {"a", "b", "a"};
+    EXPECT_EQ(strings.find("b"), strings.begin() + 1);
+    EXPECT_EQ(strings.count("a"), 2u);
+    EXPECT_FALSE(strings.contains("c"));
+}
+
+TEST(TestMyCustomVector, EqualityByBytesAndByValues)
+{
+    MyVector<uint32_t> first(100, 7);
+    MyVector<uint32_t> second(100, 7);
+    EXPECT_EQ(first, second);
+    second[99] = 8;
+    EXPECT_NE(first, second);
+    EXPECT_EQ(MyVector<uint32_t>(), MyVector<uint32_t>());
+
+    // Floating point values are compared by value: 0.0 == -0.0
+    EXPECT_EQ(MyVector<double>({0.0, 1.0}), MyVector<double>({-0.0, 1.0}));
+}
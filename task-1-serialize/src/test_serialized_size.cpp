@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+
+#include <iostream>
+#include <sstream>
+#include <cstddef>
+#include <climits>
+#include <vector>
+#include <forward_list>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <string>
+#include "my_vector.hpp"
+
+// #include <serialize_concepts.hpp>
+// #include <serialize_sfinae.hpp>
+#include "serialize.hpp"
+
+
+namespace
+{
+    template <typename T>
+    std::size_t stream_size(const T& obj)
+    {
+        std::ostringstream oss(std::stringstream::binary);
+        serialize(obj, oss);
+        return oss.str().size();
+    }
+}
+
+
+TEST(TestSerializedSize, SimpleTypes)
+{
+    EXPECT_EQ(serialized_size('a'), stream_size('a'));
+    EXPECT_EQ(serialized_size(42), stream_size(42));
+    EXPECT_EQ(serialized_size(3.14), stream_size(3.14));
+    EXPECT_EQ(serialized_size(LLONG_MIN), stream_size(LLONG_MIN));
+}
+
+TEST(TestSerializedSize, Strings)
+{
+    std::string empty{};
+    std::string str = "Hello, World!";
+
+    EXPECT_EQ(serialized_size(empty), stream_size(empty));
+    EXPECT_EQ(serialized_size(str), stream_size(str));
+}
+
+TEST(TestSerializedSize, Vectors)
+{
+    std::vector<int> ints(1000, 7);
+    std::vector<bool> bools = {true, false, true};
+    std::vector<std::string> strings = {"", "one", "three"};
+
+    EXPECT_EQ(serialized_size(ints), stream_size(ints));
+    EXPECT_EQ(serialized_size(bools), stream_size(bools));
+    EXPECT_EQ(serialized_size(strings), stream_size(strings));
+}
+
+TEST(TestSerializedSize, AssociativeContainers)
+{
+    std::map<int, std::string> m = {{1, "one"}, {2, ""}, {3, "three"}};
+    std::set<long long> s = {1, 2, 3, 4};
+    std::unordered_map<std::string, std::vector<int>> um = {{"a", {1, 2}}, {"b", {}}};
+
+    EXPECT_EQ(serialized_size(m), stream_size(m));
+    EXPECT_EQ(serialized_size(s), stream_size(s));
+    EXPECT_EQ(serialized_size(um), stream_size(um));
+}
+
+TEST(TestSerializedSize, ForwardListAndMyVector)
+{
+    std::forward_list<std::string> fl = {"a", "bb", "ccc"};
+    MyVector<int> my_vector;
+    my_vector.push_back(1);
+    my_vector.push_back(2);
+
+    EXPECT_EQ(serialized_size(fl), stream_size(fl));
+    EXPECT_EQ(serialized_size(my_vector), stream_size(my_vector));
+}
+
+TEST(TestSerializedSize, ReserveOnceAndWrite)
+{
+    std::map<std::string, std::vector<int>> m = {
+        {"alpha", {1, 2, 3}},
+        {"beta", {}},
+        {"gamma", {4, 5}}
+    };
+
+    std::vector<std::byte> buffer;
+    buffer.reserve(serialized_size(m));
+    const std::byte* data_before = buffer.data();
+
+    VectorWriter w(buffer);
+    serialize(m, w);
+
+    EXPECT_EQ(buffer.size(), serialized_size(m));
+    EXPECT_EQ(buffer.data(), data_before);
+}
@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <string>
+#include <utility>
+#include <stdexcept>
+#include <type_traits>
+
+// #include <serialize_concepts.hpp>
+// #include <serialize_sfinae.hpp>
+#include "serialize.hpp"
+#include "serialize_instrumentation.hpp"
+#include "my_vector.hpp"
+
+
+namespace
+{
+    std::string long_string(int i)
+    {
+        return "a string that doesn't fit into SSO, number " + std::to_string(i);
+    }
+
+    // Copying and moving throw while g_throw_on_copy is set
+    bool g_throw_on_copy = false;
+
+    struct ThrowingCopy
+    {
+        ThrowingCopy() = default;
+        ThrowingCopy(const ThrowingCopy&) { if (g_throw_on_copy) throw std::runtime_error("copy"); }
+        ThrowingCopy(ThrowingCopy&&) { if (g_throw_on_copy) throw std::runtime_error("move"); }
+        ThrowingCopy& operator=(const ThrowingCopy&) = default;
+        ThrowingCopy& operator=(ThrowingCopy&&) = default;
+    };
+}
+
+
+TEST(TestSmallVector, InlineUntilFull)
+{
+    ScopedSerializeCounters scope;
+    SmallVector<int, 16> vector;
+    EXPECT_EQ(vector.capacity(), 16u);
+    for (int i = 0; i < 16; ++i)
+        vector.push_back(i);
+    EXPECT_EQ(scope.counters().allocations, 0u);
+    EXPECT_TRUE(vector.is_inline());
+
+    // The 17th element spills all of them to the heap
+    vector.push_back(16);
+    EXPECT_EQ(scope.counters().allocations, 1u);
+    EXPECT_FALSE(vector.is_inline());
+    EXPECT_GE(vector.capacity(), 17u);
+    for (int i = 0; i < 17; ++i)
+        EXPECT_EQ(vector[i], i);
+
+    // Shrinks back into the object
+    vector.resize(10);
+    vector.shrink_to_fit();
+    EXPECT_TRUE(vector.is_inline());
+    EXPECT_EQ(vector, (SmallVector<int, 16>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+}
+
+TEST(TestSmallVector, CopyMoveAndSwap)
+{
+    SmallVector<std::string, 4> small;
+    SmallVector<std::string, 4> large;
+    for (int i = 0; i < 3; ++i)
+        small.push_back(long_string(i));
+    for (int i = 0; i < 10; ++i)
+        large.push_back(long_string(i));
+
+    SmallVector<std::string, 4> small_copy(small);
+    SmallVector<std::string, 4> large_copy = large;
+    EXPECT_EQ(small_copy, small);
+    EXPECT_EQ(large_copy, large);
+    EXPECT_TRUE(small_copy.is_inline());
+
+    // The inline elements are moved, the heap buffer is taken
+    const std::string* large_data = large.data();
+    SmallVector<std::string, 4> moved_small(std::move(small));
+    SmallVector<std::string, 4> moved_large(std::move(large));
+    EXPECT_EQ(moved_small, small_copy);
+    EXPECT_TRUE(moved_small.is_inline());
+    EXPECT_EQ(moved_large.data(), large_data);
+    EXPECT_TRUE(small.empty());
+    EXPECT_TRUE(large.empty());
+
+    moved_small.swap(moved_large);
+    EXPECT_EQ(moved_small, large_copy);
+    EXPECT_EQ(moved_large, small_copy);
+
+    moved_small = moved_large;
+    EXPECT_EQ(moved_small, small_copy);
+    moved_large = std::move(large_copy);
+    EXPECT_EQ(moved_large.size(), 10u);
+}
+
+TEST(TestSmallVector, MoveAssignmentOfThrowingElements)
+{
+    // Inline elements are moved one by one, so the assignment is noexcept only when their move is
+    static_assert(!std::is_nothrow_move_assignable_v<SmallVector<ThrowingCopy, 4>>);
+    static_assert(std::is_nothrow_move_assignable_v<SmallVector<std::string, 4>>);
+    static_assert(std::is_nothrow_move_assignable_v<MyVector<ThrowingCopy>>);
+
+    SmallVector<ThrowingCopy, 4> source(2);
+    SmallVector<ThrowingCopy, 4> target(3);
+
+    g_throw_on_copy = true;
+    EXPECT_THROW(target = std::move(source), std::runtime_error);
+    g_throw_on_copy = false;
+
+    EXPECT_TRUE(target.empty());
+    EXPECT_TRUE(target.is_inline());
+}
+
+TEST(TestSmallVector, SerializeWithoutAllocations)
+{
+    SmallVector<int, 16> vector = {1, -2, 3, -4, 5};
+    std::vector<int> std_vector = {1, -2, 3, -4, 5};
+
+    std::vector<std::byte> buffer;
+    std::vector<std::byte> std_buffer;
+    VectorWriter w(buffer);
+    VectorWriter std_w(std_buffer);
+    serialize(vector, w);
+    serialize(std_vector, std_w);
+    EXPECT_EQ(buffer, std_buffer);
+    EXPECT_EQ(serialized_size(vector), buffer.size());
+
+    SmallVector<int, 16> deserialized_vector;
+    SpanReader r(buffer);
+    EXPECT_EQ(counted_deserialize(deserialized_vector, r).allocations, 0u);
+    EXPECT_EQ(deserialized_vector, vector);
+}
+
+TEST(TestSmallVector, NestedInContainers)
+{
+    std::vector<SmallVector<std::string, 2>> vectors(5);
+    for (int i = 0; i < 5; ++i)
+        for (int j = 0; j < i; ++j)
+            vectors[i].push_back(long_string(j));
+
+    std::vector<std::byte> buffer;
+    VectorWriter w(buffer);
+    serialize(vectors, w);
+
+    std::vector<SmallVector<std::string, 2>> result;
+    SpanReader r(buffer);
+    deserialize(result, r);
+    EXPECT_EQ(result, vectors);
+}
@@ -208,4 +208,36 @@ TEST(TestString, StringMaxSize) {
     deserialize(deserialized_str, iss);
 
     EXPECT_EQ(s, deserialized_str);
-}
\ No newline at end of file
+}
+
+TEST(TestString, WhitespaceWithoutNoskipws) {
+    // Reads are unformatted, so the stream does not need std::noskipws
+    std::string s = " \n\t\r\v\f text with spaces \n";
+    s.push_back(' ');
+    std::ostringstream oss(std::stringstream::binary);
+
+    serialize(s, oss);
+
+    std::istringstream iss(oss.str(), std::stringstream::binary);
+
+    std::string deserialized_str{};
+
+    deserialize(deserialized_str, iss);
+
+    EXPECT_EQ(s, deserialized_str);
+}
+
+TEST(TestString, EmptyStringOverwritesOldValue) {
+    std::string s = "";
+    std::ostringstream oss(std::stringstream::binary);
+
+    serialize(s, oss);
+
+    std::istringstream iss(oss.str(), std::stringstream::binary);
+
+    std::string deserialized_str = "Trash data";
+
+    deserialize(deserialized_str, iss);
+
+    EXPECT_EQ(s, deserialized_str);
+}
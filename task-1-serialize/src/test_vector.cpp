@@ -195,4 +195,27 @@ TEST(TestVectors, VectorVectorVectorString) {
     deserialize(deserialized_vector, iss);
 
     EXPECT_EQ(vec, deserialized_vector);
-}
\ No newline at end of file
+}
+
+TEST(TestVectors, VectorFloatLargeBulk) {
+    std::vector<float> vec(100000);
+    for (size_t i = 0; i < vec.size(); ++i) {
+        vec[i] = static_cast<float>(i) * 0.5f - 1000.0f;
+    }
+    std::ostringstream oss(std::stringstream::binary);
+
+    serialize(vec, oss);
+
+    // The bulk path writes exactly the same bytes as the element-by-element path
+    EXPECT_EQ(oss.str().size(), sizeof(uint32_t) + vec.size() * sizeof(float));
+
+    std::istringstream iss(oss.str(), std::stringstream::binary);
+    iss >> std::noskipws;
+
+    std::vector<float> deserialized_vector = {1.0f, 2.0f};  // Trash data
+
+    deserialize(deserialized_vector, iss);
+
+    EXPECT_EQ(vec, deserialized_vector);
+}
+
@@ -0,0 +1,252 @@
+#include <gtest/gtest.h>
+
+#include <iostream>
+#include <sstream>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+#include <map>
+#include <string>
+#include <string_view>
+#include <span>
+#include "my_vector.hpp"
+
+// #include <serialize_concepts.hpp>
+// #include <serialize_sfinae.hpp>
+#include "serialize.hpp"
+
+
+TEST(TestViews, StringViewPointsIntoBuffer)
+{
+    std::string str = "Hello, zero-copy!";
+
+    std::vector<std::byte> buffer;
+    VectorWriter w(buffer);
+    serialize(str, w);
+
+    SpanReader r(buffer);
+    std::string_view view{};
+    deserialize(view, r);
+
+    EXPECT_EQ(view, str);
+    EXPECT_EQ(reinterpret_cast<const std::byte*>(view.data()), buffer.data() + sizeof(uint32_t));
+    EXPECT_EQ(r.remaining(), 0u);
+}
+
+TEST(TestViews, EmptyStringView)
+{
+    std::vector<std::byte> buffer;
+    VectorWriter w(buffer);
+    serialize(std::string(), w);
+
+    SpanReader r(buffer);
+    std::string_view view = "Trash data";
+    deserialize(view, r);
+
+    EXPECT_TRUE(view.empty());
+}
+
+TEST(TestViews, StringViewHasStringFormat)
+{
+    std::string_view view = "same bytes";
+
+    std::ostringstream view_oss(std::stringstream::binary);
+    std::ostringstream str_oss(std::stringstream::binary);
+    serialize(view, view_oss);
+    serialize(std::string(view), str_oss);
+
+    EXPECT_EQ(view_oss.str(), str_oss.str());
+    EXPECT_EQ(serialized_size(view), view_oss.str().size());
+}
+
+TEST(TestViews, VarintStringViewRoundTrip)
+{
+    // Characters above 0x7f would take two bytes each if they were written as varints
+    std::string_view view = "h\xe9llo";
+
+    std::vector<std::byte> view_buffer;
+    VectorWriter view_writer(view_buffer);
+    auto w = with_encoding<VarintEncoding>(view_writer);
+    serialize(view, w);
+
+    std::vector<std::byte> str_buffer;
+    VectorWriter str_writer(str_buffer);
+    auto str_w = with_encoding<VarintEncoding>(str_writer);
+    serialize(std::string(view), str_w);
+
+    EXPECT_EQ(view_buffer, str_buffer);
+    EXPECT_EQ(view_buffer.size(), 1 + view.size());
+    EXPECT_EQ(serialized_size<VarintEncoding>(view), view_buffer.size());
+
+    SpanReader inner_reader(view_buffer);
+    auto r = with_decoding<VarintEncoding>(inner_reader);
+    std::string_view deserialized_view{};
+    deserialize(deserialized_view, r);
+
+    EXPECT_EQ(deserialized_view, view);
+    EXPECT_EQ(inner_reader.remaining(), 0u);
+}
+
+TEST(TestViews, FrontEndsWriteTheSameBytes)
+{
+    // The same expected bytes are checked by tests_sfinae and tests_concepts, so both front-ends encode the views alike
+    const auto bytes = [](std::initializer_list<unsigned> values) {
+        std::vector<std::byte> result;
+        for (unsigned value : values)
+            result.push_back(static_cast<std::byte>(value));
+        return result;
+    };
+
+    std::vector<double> doubles = {1.0};
+
+    std::vector<std::byte> fixed_buffer;
+    VectorWriter fixed_writer(fixed_buffer);
+    auto fixed_w = with_encoding<LittleEndianEncoding>(fixed_writer);
+    serialize(std::string_view("ab"), fixed_w);
+    serialize(std::span<const double>(doubles), fixed_w);
+
+    EXPECT_EQ(fixed_buffer, bytes({2, 0, 0, 0, 'a', 'b',
+                                   1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0xf0, 0x3f}));
+
+    std::vector<uint16_t> numbers = {1, 0x1234};
+
+    std::vector<std::byte> varint_buffer;
+    VectorWriter varint_writer(varint_buffer);
+    auto varint_w = with_encoding<VarintEncoding>(varint_writer);
+    serialize(std::string_view("h\xe9llo"), varint_w);
+    serialize(numbers, varint_w);
+
+    EXPECT_EQ(varint_buffer, bytes({5, 'h', 0xe9, 'l', 'l', 'o',
+                                    2, 0x01, 0xb4, 0x24}));
+}
+
+TEST(TestViews, MapOfStringViews)
+{
+    std::map<std::string, std::string> m = {{"alpha", "1"}, {"beta", "22"}, {"gamma", ""}};
+
+    std::vector<std::byte> buffer;
+    VectorWriter w(buffer);
+    serialize(m, w);
+
+    // Walk the serialized map without allocating a single string
+    SpanReader r(buffer);
+    uint32_t len = 0;
+    deserialize(len, r);
+    ASSERT_EQ(len, m.size());
+
+    auto it = m.begin();
+    for (uint32_t i = 0; i < len; ++i, ++it)
+    {
+        std::string_view key{};
+        std::string_view value{};
+        deserialize(key, r);
+        deserialize(value, r);
+        EXPECT_EQ(key, it->first);
+        EXPECT_EQ(value, it->second);
+    }
+}
+
+TEST(TestViews, SpanOfInts)
+{
+    std::vector<int> vec = {1, -2, 3, INT_MAX, INT_MIN};
+
+    std::vector<std::byte> buffer;
+    VectorWriter w(buffer);
+    serialize(vec, w);
+
+    SpanReader r(buffer);
+    std::span<const int> span{};
+    deserialize(span, r);
+
+    ASSERT_EQ(span.size(), vec.size());
+    EXPECT_TRUE(std::equal(span.begin(), span.end(), vec.begin()));
+    EXPECT_EQ(reinterpret_cast<const std::byte*>(span.data()), buffer.data() + sizeof(uint32_t));
+}
+
+TEST(TestViews, SpanHasVectorFormat)
+{
+    std::vector<double> vec = {0.5, -1.25, 1e100};
+    std::span<const double> span(vec);
+
+    std::ostringstream span_oss(std::stringstream::binary);
+    std::ostringstream vec_oss(std::stringstream::binary);
+    serialize(span, span_oss);
+    serialize(vec, vec_oss);
+
+    EXPECT_EQ(span_oss.str(), vec_oss.str());
+}
+
+TEST(TestViews, MisalignedSpanThrows)
+{
+    // Length prefix (4 bytes) puts the doubles at offset 4, which is not aligned for double
+    std::vector<double> vec = {1.0, 2.0};
+
+    std::vector<std::byte> buffer;
+    VectorWriter w(buffer);
+    serialize(vec, w);
+
+    SpanReader r(buffer);
+    std::span<const double> span{};
+
+    EXPECT_THROW(deserialize(span, r), SerializeBufferError);
+}
+
+TEST(TestViews, AlignedEncodingSpans)
+{
+    std::string name = "abc";
+    std::vector<double> doubles = {1.0, 2.5, -3.75};
+    std::vector<uint64_t> ids = {1, 2, 3, 1ull << 63};
+
+    std::vector<std::byte> buffer;
+    VectorWriter inner_writer(buffer);
+    auto w = with_encoding<AlignedEncoding>(inner_writer);
+    serialize(name, w);
+    serialize(doubles, w);
+    serialize(ids, w);
+
+    SpanReader inner_reader(buffer);
+    auto r = with_decoding<AlignedEncoding>(inner_reader);
+    std::string_view name_view{};
+    std::span<const double> doubles_view{};
+    std::span<const uint64_t> ids_view{};
+    deserialize(name_view, r);
+    deserialize(doubles_view, r);
+    deserialize(ids_view, r);
+
+    EXPECT_EQ(name_view, name);
+    EXPECT_TRUE(std::equal(doubles_view.begin(), doubles_view.end(), doubles.begin(), doubles.end()));
+    EXPECT_TRUE(std::equal(ids_view.begin(), ids_view.end(), ids.begin(), ids.end()));
+    EXPECT_EQ(inner_reader.remaining(), 0u);
+}
+
+TEST(TestViews, AlignedEncodingRoundTripsContainers)
+{
+    std::vector<std::vector<double>> nested = {{1.0}, {}, {2.0, 3.0}};
+    MyVector<long long> my_vector;
+    my_vector.push_back(-1);
+    my_vector.push_back(LLONG_MAX);
+
+    std::vector<std::byte> buffer;
+    VectorWriter inner_writer(buffer);
+    auto w = with_encoding<AlignedEncoding>(inner_writer);
+    serialize('x', w);
+    serialize(nested, w);
+    serialize(my_vector, w);
+
+    EXPECT_LE(buffer.size(), serialized_size<AlignedEncoding>('x') + serialized_size<AlignedEncoding>(nested) 
+                             + serialized_size<AlignedEncoding>(my_vector));
+
+    SpanReader inner_reader(buffer);
+    auto r = with_decoding<AlignedEncoding>(inner_reader);
+    char c{};
+    std::vector<std::vector<double>> deserialized_nested{};
+    MyVector<long long> deserialized_my_vector{};
+    deserialize(c, r);
+    deserialize(deserialized_nested, r);
+    deserialize(deserialized_my_vector, r);
+
+    EXPECT_EQ(c, 'x');
+    EXPECT_EQ(nested, deserialized_nested);
+    EXPECT_EQ(my_vector, deserialized_my_vector);
+    EXPECT_EQ(inner_reader.remaining(), 0u);
+}
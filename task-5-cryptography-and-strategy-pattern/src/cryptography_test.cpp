@@ -5,6 +5,8 @@
 #include "cryptography.hpp"
 #include "serialize_concepts.hpp"
 #include "trie.hpp"
+#include "trie_serialize.hpp"
+#include "batch_serialize.hpp"
 
 
 using namespace Cryptography;
@@ -729,3 +731,144 @@ TEST(EncryptTrie, CBCandTEA)
         ++it2;
     }
 }
+
+
+
+namespace
+{
+    template <typename T>
+    Containers::Trie<T> round_trip_trie(const Containers::Trie<T>& trie)
+    {
+        std::ostringstream oss(std::stringstream::binary);
+        serialize(trie, oss);
+
+        std::istringstream iss(oss.str(), std::stringstream::binary);
+        iss >> std::noskipws;
+        Containers::Trie<T> result{};
+        result.insert("trash", T{});
+        deserialize(result, iss);
+        return result;
+    }
+
+    template <typename T>
+    void expect_equal_tries(const Containers::Trie<T>& trie, const Containers::Trie<T>& other)
+    {
+        ASSERT_EQ(trie.size(), other.size());
+        auto it = trie.begin();
+        auto it2 = other.begin();
+        for (size_t i = 0; i < trie.size(); ++i)
+        {
+            EXPECT_EQ(*it, *it2);
+            ++it;
+            ++it2;
+        }
+    }
+}
+
+
+TEST(SerializeTrie, SharedPrefixes)
+{
+    Containers::Trie<int> trie{};
+    for (int i = 0; i < 1000; i++)
+        trie.insert("common/prefix/of/the/key/" + std::to_string(i), i);
+    trie.insert("c", -1);
+    trie.insert("common", -2);
+
+    Containers::Trie<int> trie2 = round_trip_trie(trie);
+    expect_equal_tries(trie, trie2);
+
+    // The deserialized trie works as usual
+    EXPECT_EQ(trie2.find("common/prefix/of/the/key/500")->second, 500);
+    EXPECT_EQ(trie2.find("common")->second, -2);
+    EXPECT_EQ(trie2.GetSubTrie("common/prefix/of/the/key/1").size(), 111u);
+    EXPECT_EQ(trie2.erase("c"), 1u);
+    EXPECT_EQ(trie2.size(), trie.size() - 1);
+}
+
+TEST(SerializeTrie, PrefixesAreWrittenOnce)
+{
+    Containers::Trie<int> trie{};
+    std::map<std::string, int> map;
+    for (int i = 0; i < 1000; i++)
+    {
+        trie.insert("common/prefix/of/the/key/" + std::to_string(i), i);
+        map["common/prefix/of/the/key/" + std::to_string(i)] = i;
+    }
+
+    std::ostringstream trie_oss(std::stringstream::binary);
+    serialize(trie, trie_oss);
+    std::ostringstream map_oss(std::stringstream::binary);
+    serialize(map, map_oss);
+
+    EXPECT_LT(trie_oss.str().size() * 2, map_oss.str().size());
+}
+
+TEST(SerializeTrie, EmptyTrieAndErasedKeys)
+{
+    Containers::Trie<int> empty{};
+    EXPECT_TRUE(round_trip_trie(empty).empty());
+
+    Containers::Trie<std::string> trie{};
+    trie.insert("apple", "red");
+    trie.insert("apricot", "orange");
+    trie.insert("banana", "yellow");
+    trie.erase("apricot");
+
+    Containers::Trie<std::string> trie2 = round_trip_trie(trie);
+    expect_equal_tries(trie, trie2);
+    EXPECT_EQ(trie2.find("apricot"), trie2.end());
+}
+
+TEST(SerializeTrie, SerializedSizeAndBatches)
+{
+    Containers::Trie<std::string> trie{};
+    for (int i = 0; i < 300; i++)
+        trie.insert("key/" + std::to_string(i), std::string(i % 7, 'v'));
+
+    std::vector<std::byte> buffer;
+    VectorWriter w(buffer);
+    serialize(trie, w);
+    EXPECT_EQ(serialized_size(trie), buffer.size());
+
+    std::vector<std::byte> varint_buffer;
+    VectorWriter inner_writer(varint_buffer);
+    auto varint_w = with_encoding<VarintEncoding>(inner_writer);
+    serialize(trie, varint_w);
+    EXPECT_EQ(serialized_size<VarintEncoding>(trie), varint_buffer.size());
+
+    std::ostringstream oss(std::stringstream::binary);
+    serialize_all(oss, 42, trie, std::string("tail"));
+
+    std::istringstream iss(oss.str(), std::stringstream::binary);
+    int head = 0;
+    Containers::Trie<std::string> trie2{};
+    std::string tail{};
+    deserialize_all(iss, head, trie2, tail);
+
+    EXPECT_EQ(head, 42);
+    expect_equal_tries(trie, trie2);
+    EXPECT_EQ(tail, "tail");
+}
+
+TEST(SerializeTrie, InvalidStreamThrows)
+{
+    Containers::Trie<int> trie{};
+    trie.insert("ab", 1);
+    trie.insert("ac", 2);
+
+    std::ostringstream oss(std::stringstream::binary);
+    serialize(trie, oss);
+    std::string bytes = oss.str();
+
+    std::istringstream truncated(bytes.substr(0, bytes.size() - 3), std::stringstream::binary);
+    truncated >> std::noskipws;
+    Containers::Trie<int> trie2{};
+    EXPECT_THROW(deserialize(trie2, truncated), SerializeBufferError);
+
+    // The root header is: has_value (1 byte), number of children (2 bytes)
+    bytes[0] = 1;
+    std::istringstream root_with_value(bytes, std::stringstream::binary);
+    root_with_value >> std::noskipws;
+    Containers::Trie<int> trie3{};
+    EXPECT_THROW(deserialize(trie3, root_with_value), SerializeBufferError);
+}
@@ -26,6 +26,10 @@
 */
 namespace Containers
 {
+    // Structural serialization of Trie (trie_serialize.hpp), it works with the nodes directly
+    template <typename T>
+    struct TrieStructure;
+
     template<typename _Iter, typename _ValueType>
     concept InputIteratorConcept = std::is_base_of_v<
                                         std::input_iterator_tag,
@@ -298,6 +302,8 @@ namespace Containers
 
 
     private:
+        friend struct TrieStructure<T>;
+
         std::shared_ptr<Node> m_root = nullptr;
 
         std::shared_ptr<Node> first_node_with_value() const
@@ -0,0 +1,209 @@
+#pragma once
+
+#include <iostream>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "serialize_concepts.hpp"
+#include "trie.hpp"
+
+
+/*
+Structural serialization of Containers::Trie. The generic container serializer writes every
+key in full and the deserializer inserts the keys one by one, walking from the root every time.
+Here the nodes are written once in preorder, so common prefixes are written once too:
+
+    node:  uint8_t has_value, the value (if has_value), uint16_t number of children,
+           for every child (in order of the edge bytes): uint8_t edge byte, the child node
+
+The root is written as a node too. The deserializer rebuilds the nodes in one pass over the
+stream, without searching for the keys. Walks use an explicit stack, so long keys don't
+overflow the call stack. serialized_size() walks the nodes in the same order without writing
+them. Like all serializers of task 1, it works with any writer / reader and throws
+SerializeBufferError on invalid data.
+*/
+
+
+namespace Containers
+{
+    template <typename T>
+    struct TrieStructure
+    {
+        using Node = typename Trie<T>::Node;
+
+        template <typename Writer>
+        static void write(const Trie<T>& trie, Writer& w)
+        {
+            walk(trie,
+                 [&](const Node& node) { write_node_header(node, w); },
+                 [&](uint8_t edge) { serialize(edge, w); });
+        }
+
+        template <typename Encoding>
+        static std::size_t size(const Trie<T>& trie)
+        {
+            std::size_t result = 0;
+            walk(trie,
+                 [&](const Node& node) { result += node_header_size<Encoding>(node); },
+                 [&](uint8_t edge) { result += serialized_size<Encoding>(edge); });
+            return result;
+        }
+
+        template <typename Reader>
+        static void read(Trie<T>& trie, Reader& r)
+        {
+            trie.clear();
+
+            std::shared_ptr<Node> root = trie.m_root;
+            const std::size_t root_children = read_node_header(*root, r);
+            if (root->m_has_value) throw SerializeBufferError("Invalid trie: the root cannot have a value.");
+
+            // Node, the number of children left to read and the last edge byte
+            struct Frame
+            {
+                std::shared_ptr<Node> node;
+                std::size_t children_left;
+                int last_edge;
+            };
+            std::vector<Frame> stack;
+            stack.push_back(Frame{root, root_children, -1});
+
+            while (!stack.empty())
+            {
+                Frame& frame = stack.back();
+                if (frame.children_left == 0)
+                {
+                    // The subtree is complete, its size goes to the parent
+                    std::shared_ptr<Node> node = frame.node;
+                    node->m_subtree_size += node->m_has_value ? 1 : 0;
+                    stack.pop_back();
+                    if (!stack.empty()) stack.back().node->m_subtree_size += node->m_subtree_size;
+                    continue;
+                }
+                --frame.children_left;
+
+                uint8_t edge = 0;
+                deserialize(edge, r);
+                if (reader_failed(r)) throw SerializeBufferError("Invalid trie: unexpected end of the stream.");
+                if (static_cast<int>(edge) <= frame.last_edge) throw SerializeBufferError("Invalid trie: the children are not in order.");
+                frame.last_edge = edge;
+
+                std::shared_ptr<Node> parent = frame.node;
+                std::shared_ptr<Node> child = Node::create(parent->m_data.first + static_cast<char>(edge), edge, std::weak_ptr<Node>(parent));
+                parent->m_children[edge] = child;
+
+                std::size_t children = read_node_header(*child, r);
+                if (!child->m_has_value && children == 0) throw SerializeBufferError("Invalid trie: a leaf without a value.");
+
+                stack.push_back(Frame{child, children, -1});
+            }
+        }
+
+    private:
+        // Preorder walk: on_node for every node, on_edge with the edge byte before every child
+        template <typename OnNode, typename OnEdge>
+        static void walk(const Trie<T>& trie, OnNode&& on_node, OnEdge&& on_edge)
+        {
+            // Node and the index of the next child to visit
+            std::vector<std::pair<const Node*, std::size_t>> stack;
+            on_node(*trie.m_root);
+            stack.emplace_back(trie.m_root.get(), 0);
+
+            while (!stack.empty())
+            {
+                auto& [node, index] = stack.back();
+                while (index < node->m_children.size() && node->m_children[index] == nullptr)
+                    ++index;
+
+                if (index == node->m_children.size())
+                {
+                    stack.pop_back();
+                    continue;
+                }
+
+                const Node* child = node->m_children[index].get();
+                on_edge(static_cast<uint8_t>(index));
+                ++index;
+
+                on_node(*child);
+                stack.emplace_back(child, 0);
+            }
+        }
+
+        static uint16_t child_count(const Node& node)
+        {
+            uint16_t children = 0;
+            for (const auto& child : node.m_children)
+                if (child != nullptr) ++children;
+            return children;
+        }
+
+        template <typename Writer>
+        static void write_node_header(const Node& node, Writer& w)
+        {
+            serialize(static_cast<uint8_t>(node.m_has_value ? 1 : 0), w);
+            if (node.m_has_value) serialize(node.m_data.second, w);
+            serialize(child_count(node), w);
+        }
+
+        template <typename Encoding>
+        static std::size_t node_header_size(const Node& node)
+        {
+            std::size_t result = serialized_size<Encoding>(static_cast<uint8_t>(node.m_has_value ? 1 : 0));
+            if (node.m_has_value) result += serialized_size<Encoding>(node.m_data.second);
+            return result + serialized_size<Encoding>(child_count(node));
+        }
+
+        template <typename Reader>
+        static std::size_t read_node_header(Node& node, Reader& r)
+        {
+            uint8_t has_value = 0;
+            deserialize(has_value, r);
+            if (has_value > 1) throw SerializeBufferError("Invalid trie: wrong value flag.");
+
+            node.m_has_value = has_value == 1;
+            if (node.m_has_value) deserialize(node.m_data.second, r);
+
+            uint16_t children = 0;
+            deserialize(children, r);
+            if (reader_failed(r)) throw SerializeBufferError("Invalid trie: unexpected end of the stream.");
+            if (children > node.m_children.size()) throw SerializeBufferError("Invalid trie: too many children.");
+
+            return children;
+        }
+    };
+}
+
+
+template <typename T>
+struct serializer<Containers::Trie<T>>
+{
+    template <BufferWriter Writer>
+    static void apply(const Containers::Trie<T>& trie, Writer& w)
+    {
+        // std::cout << "Using structural trie serializer" << std::endl;
+
+        Containers::TrieStructure<T>::write(trie, w);
+    }
+
+    template <typename Encoding>
+    static std::size_t size(const Containers::Trie<T>& trie)
+    {
+        return Containers::TrieStructure<T>::template size<Encoding>(trie);
+    }
+};
+
+template <typename T>
+struct deserializer<Containers::Trie<T>>
+{
+    template <BufferReader Reader>
+    static void apply(Containers::Trie<T>& trie, Reader& r)
+    {
+        // std::cout << "Using structural trie deserializer" << std::endl;
+
+        Containers::TrieStructure<T>::read(trie, r);
+    }
+};